@@ -0,0 +1,80 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "binary_splitting.hpp"
+
+int main(int argc, char *argv[]) {
+  if (argc > 3) {
+    std::cout << "Computes e with n decimal digits of precision\n"
+                 "\n"
+                 "Usage:\n"
+              << argv[0] << " [precision] [workers]\n"
+              << "\n"
+                 "The series is split between the given number of worker "
+                 "processes.\n";
+    return EXIT_FAILURE;
+  }
+
+  int dec_precision{100};
+  int workers{1};
+  try {
+    if (argc >= 2) {
+      dec_precision = std::stoi(argv[1]);
+    }
+    if (argc >= 3) {
+      workers = std::stoi(argv[2]);
+    }
+  } catch (...) {
+    std::cerr << "Exception raised when converting arguments to integers\n";
+    return EXIT_FAILURE;
+  }
+
+  if (dec_precision < 0 || workers <= 0) {
+    std::cerr << "Precision must be non-negative and workers positive\n";
+    return EXIT_FAILURE;
+  }
+
+  // 2^10 = 1024
+  // 10^3 = 1000
+  const auto bin_precision{(10 * dec_precision + 2) / 3 + 32};
+
+  // Enough terms for n! to exceed 10^precision, log10(n!) ~ n log10(n / e).
+  std::uint64_t terms{2};
+  while (static_cast<double>(terms) * std::log10(terms / std::exp(1.0)) <
+         dec_precision + 10) {
+    terms++;
+  }
+
+  ln::SplitSeries series{};
+  series.p = [](std::uint64_t) { return ln::Longnum(1); };
+  series.q = [](std::uint64_t n) { return ln::Longnum(n == 0 ? 1 : n); };
+  series.a = [](std::uint64_t) { return ln::Longnum(1); };
+
+  auto start{std::chrono::high_resolution_clock::now()};
+
+  ln::Longnum e{};
+  try {
+    const auto sum{ln::distributed_split(series, 0, terms,
+                                         static_cast<std::size_t>(workers))};
+    e = ln::div(sum.t, sum.q, bin_precision);
+  } catch (const std::exception &err) {
+    std::cerr << "Can't compute the series: " << err.what() << '\n';
+    return EXIT_FAILURE;
+  }
+
+  auto end{std::chrono::high_resolution_clock::now()};
+  auto duration{
+      std::chrono::duration_cast<std::chrono::milliseconds>(end - start)};
+
+  std::cout << "First " << dec_precision
+            << " decimal floating point places of e are:\n\n";
+  e.write_decimal(std::cout, dec_precision);
+  std::cout << '\n';
+  std::cout << "\nComputed with " << workers << " workers in " << duration
+            << '\n';
+
+  return EXIT_SUCCESS;
+}
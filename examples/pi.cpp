@@ -1,20 +1,32 @@
+#include <algorithm>
 #include <chrono>
 #include <cstdlib>
 #include <iostream>
+#include <memory>
+#include <vector>
 
 #include "longnum.hpp"
+#include "longnum_checkpoint.hpp"
 
 int main(int argc, char *argv[]) {
-  if (argc > 2) {
+  if (argc > 4) {
     std::cout << "Computes pi with n decimal digits of precision\n"
                  "\n"
                  "Usage:\n"
-              << argv[0] << " [precision]\n";
+              << argv[0]
+              << " [precision] [checkpoint directory] [checkpoint "
+                 "interval]\n"
+              << "\n"
+                 "With a checkpoint directory, progress is saved there every "
+                 "checkpoint interval\n"
+                 "seconds (10 by default) and an interrupted run with the "
+                 "same precision\n"
+                 "resumes from it.\n";
     return EXIT_FAILURE;
   }
 
   int dec_precision{100};
-  if (argc == 2) {
+  if (argc >= 2) {
     try {
       dec_precision = std::stoi(argv[1]);
     } catch (...) {
@@ -28,6 +40,22 @@ int main(int argc, char *argv[]) {
     return EXIT_FAILURE;
   }
 
+  int interval{10};
+  if (argc == 4) {
+    try {
+      interval = std::stoi(argv[3]);
+    } catch (...) {
+      std::cerr << "Exception raised when converting checkpoint interval to "
+                   "an integer\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (interval < 0) {
+    std::cerr << "Checkpoint interval must be non-negative\n";
+    return EXIT_FAILURE;
+  }
+
   // 2^10 = 1024
   // 10^3 = 1000
   auto bin_precision{(10 * dec_precision + 2) / 3};
@@ -35,21 +63,49 @@ int main(int argc, char *argv[]) {
   // Align to make shifts faster
   bin_precision = static_cast<long long>((bin_precision * 32 + 31)) / 32 + 32;
 
-  ln::Longnum pi(0, bin_precision);
   ln::Longnum n1(1);
   ln::Longnum n2(2);
   ln::Longnum n4(4);
   ln::Longnum n8(8);
 
-  ln::Longnum a(1, bin_precision);
-  ln::Longnum b(4, bin_precision);
-  ln::Longnum c(5, bin_precision);
-  ln::Longnum d(6, bin_precision);
-  ln::Longnum pow16(1);
+  // Loop state: precision it was computed with, pi, a, b, c, d and pow16
+  std::vector<ln::Longnum> state{ln::Longnum(dec_precision),
+                                 ln::Longnum(0, bin_precision),
+                                 ln::Longnum(1, bin_precision),
+                                 ln::Longnum(4, bin_precision),
+                                 ln::Longnum(5, bin_precision),
+                                 ln::Longnum(6, bin_precision),
+                                 ln::Longnum(1)};
+  auto &pi{state[1]};
+  auto &a{state[2]};
+  auto &b{state[3]};
+  auto &c{state[4]};
+  auto &d{state[5]};
+  auto &pow16{state[6]};
+
+  std::unique_ptr<ln::Checkpointer> checkpointer{};
+  int first{0};
+  if (argc >= 3) {
+    try {
+      checkpointer = std::make_unique<ln::Checkpointer>(argv[2]);
+      auto snapshot{checkpointer->load()};
+      if (snapshot && snapshot->state.size() == state.size() &&
+          snapshot->state[0] == state[0]) {
+        // Moved into the existing elements, the references above stay valid.
+        std::ranges::move(snapshot->state, state.begin());
+        first = static_cast<int>(snapshot->step);
+        std::cout << "Resuming from step " << first << "\n\n";
+      }
+    } catch (const std::exception &e) {
+      std::cerr << "Can't use checkpoints: " << e.what() << '\n';
+      return EXIT_FAILURE;
+    }
+  }
 
   auto start{std::chrono::high_resolution_clock::now()};
+  auto last_checkpoint{start};
 
-  for (int i{0}; i <= dec_precision; i++) {
+  for (int i{first}; i <= dec_precision; i++) {
     pi += (n4 / a - n2 / b - n1 / c - n1 / d) / pow16;
 
     pow16 *= 16;
@@ -57,6 +113,18 @@ int main(int argc, char *argv[]) {
     b += n8;
     c += n8;
     d += n8;
+
+    auto now{std::chrono::high_resolution_clock::now()};
+    if (checkpointer &&
+        now - last_checkpoint >= std::chrono::seconds(interval)) {
+      checkpointer->save(i + 1, state);
+      last_checkpoint = now;
+    }
+  }
+
+  if (checkpointer) {
+    checkpointer->save(dec_precision + 1, state);
+    checkpointer->wait();
   }
 
   auto end{std::chrono::high_resolution_clock::now()};
@@ -65,7 +133,8 @@ int main(int argc, char *argv[]) {
 
   std::cout << "First " << dec_precision
             << " decimal floating point places of pi are:\n\n";
-  std::cout << pi.to_string(dec_precision) << '\n';
+  pi.write_decimal(std::cout, dec_precision);
+  std::cout << '\n';
   std::cout << "\nComputed in " << duration << '\n';
 
   return EXIT_SUCCESS;
@@ -0,0 +1,61 @@
+#ifndef BINARY_SPLITTING_HPP
+#define BINARY_SPLITTING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+
+#include "longnum.hpp"
+
+namespace ln {
+
+// A series
+//
+//   sum over n of a(n) * (p(first) * ... * p(n)) / (q(first) * ... * q(n))
+//
+// with integer p(n), q(n) and a(n), like most series for constants (e, pi
+// by Chudnovsky, log 2, ...) are. Functions may be called in any order and
+// from other processes, see `distributed_split`.
+struct SplitSeries {
+  std::function<Longnum(std::uint64_t n)> p{};
+  std::function<Longnum(std::uint64_t n)> q{};
+  std::function<Longnum(std::uint64_t n)> a{};
+};
+
+// Products of p(n) and q(n) over a range of terms and the sum of the terms
+// scaled by the product of q(n), so that the sum of the series over the range
+// is `t` / `q`. All three are integers.
+struct SplitResult {
+  Longnum p{1};
+  Longnum q{1};
+  Longnum t{0};
+};
+
+// Joins the results of two adjacent ranges, `left` being the lower one.
+SplitResult merge(const SplitResult &left, const SplitResult &right);
+
+// Sums the series over [`first`, `last`) by binary splitting: the range is
+// halved recursively and the halves are joined with `merge`, so that most of
+// the work is done on numbers of similar sizes. An empty range gives p = q = 1
+// and t = 0.
+SplitResult binary_split(const SplitSeries &series, std::uint64_t first,
+                         std::uint64_t last);
+
+// Same as `binary_split`, but the range is divided into `workers` subranges
+// with the same number of terms, and each one is summed by a worker process
+// forked from the current one. Workers send their results back over Unix
+// socket pairs in the `Longnum::write_binary` format, and the calling process
+// joins them with a balanced tree of `merge`s.
+//
+// Workers inherit `series` with the rest of the memory, so nothing has to be
+// serialized, but the usual rules of `fork` apply: the process shouldn't run
+// other threads at the moment. Throws if `workers` is 0 and if a worker
+// can't be started or doesn't report a result, e. g. because `series` threw
+// in it.
+SplitResult distributed_split(const SplitSeries &series, std::uint64_t first,
+                              std::uint64_t last, std::size_t workers);
+
+} // namespace ln
+
+#endif
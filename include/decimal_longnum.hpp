@@ -0,0 +1,153 @@
+#ifndef DECIMAL_LONGNUM_HPP
+#define DECIMAL_LONGNUM_HPP
+
+#include <compare>
+#include <concepts>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "longnum.hpp"
+
+namespace ln {
+
+// A decimal fixed-point type: an integer in radix 10^9 limbs and a count of
+// decimal digits for fraction, the scale. Decimal input and output are a
+// single linear pass over the limbs, and addition, subtraction and
+// multiplication are exact, so a number that is read, added up and written
+// back never goes through a radix conversion.
+//
+// Conversions to and from `Longnum` split numbers by powers of 10^9 and go
+// through the same divide-and-conquer path as `Longnum`'s decimal I/O.
+//
+// Results of addition and subtraction get the largest scale of the
+// operands, products get the sum of the scales. Digits that don't fit are
+// truncated towards zero, like `Longnum` does.
+class DecimalLongnum {
+public:
+  using Limb = std::uint32_t;
+  using Limbs = std::vector<Limb>;
+  using Scale = std::uint32_t;
+
+  // Decimal digits in a limb.
+  static constexpr int limb_digits{9};
+
+  // Radix of the limbs, 10^`limb_digits`.
+  static constexpr Limb limb_radix{1'000'000'000};
+
+  ~DecimalLongnum() = default;
+  DecimalLongnum(const DecimalLongnum &other) = default;
+  DecimalLongnum &operator=(const DecimalLongnum &other) = default;
+  DecimalLongnum(DecimalLongnum &&other) = default;
+  DecimalLongnum &operator=(DecimalLongnum &&other) = default;
+
+  // Initialization with 0.
+  DecimalLongnum() = default;
+
+  // Initialization with any primitive integral value.
+  template <std::integral T> DecimalLongnum(T other);
+
+  // Exact conversion from a `Longnum`. A binary fraction of n bits takes n
+  // decimal digits, so the scale is the precision of `other`, or 0 if it's
+  // negative.
+  explicit DecimalLongnum(const Longnum &other);
+
+  // Conversion to a `Longnum` with `prec` bits for fraction. Throws if
+  // `prec` is negative.
+  Longnum to_longnum(Longnum::Precision prec) const;
+
+  // Reads a number like "-123.4500". The scale is the number of digits after
+  // the point, so trailing zeros are kept. Throws if `str` is malformed.
+  static DecimalLongnum from_string(std::string_view str);
+
+  // Converts to a string with `get_scale()` decimal places.
+  std::string to_string() const;
+
+  // Converts to a string with `fp_digits` decimal places after the floating
+  // point.
+  std::string to_string(Scale fp_digits) const;
+
+  // How many decimal digits are used for fraction.
+  Scale get_scale() const;
+
+  // Changes the scale. If it decreases, the digits that don't fit are
+  // truncated towards zero.
+  DecimalLongnum &set_scale(Scale scale);
+
+  // Returns an int that:
+  // 1. is 0 if a number is 0.
+  // 2. is negative if a number is negative.
+  // 3. is positive if a number is positive.
+  int sign() const;
+
+  // The usual spaceship operator, nothing crazy.
+  std::strong_ordering operator<=>(const DecimalLongnum &other) const;
+
+  // Checks if the numbers are equal.
+  bool operator==(const DecimalLongnum &other) const;
+
+  // Adds two numbers.
+  DecimalLongnum operator+(const DecimalLongnum &other) const;
+
+  // Adds two numbers.
+  DecimalLongnum &operator+=(const DecimalLongnum &other);
+
+  // Unary minus, just makes a copy with an opposite sign.
+  DecimalLongnum operator-() const;
+
+  // Subtracts one number from another.
+  DecimalLongnum operator-(const DecimalLongnum &other) const;
+
+  // Subtracts one number from another.
+  DecimalLongnum &operator-=(const DecimalLongnum &other);
+
+  // Multiplies two numbers. Throws if the sum of the scales is out of range.
+  DecimalLongnum operator*(const DecimalLongnum &other) const;
+
+  // Multiplies two numbers. Throws if the sum of the scales is out of range.
+  DecimalLongnum &operator*=(const DecimalLongnum &other);
+
+  // Divides one number by another. Unlike the other operations, this one
+  // goes through binary limbs. Throws if `other` is 0.
+  DecimalLongnum operator/(const DecimalLongnum &other) const;
+
+  // Divides one number by another. Unlike the other operations, this one
+  // goes through binary limbs. Throws if `other` is 0.
+  DecimalLongnum &operator/=(const DecimalLongnum &other);
+
+#ifndef LONGNUM_TEST_PRIVATE
+private:
+#endif
+  // Absolute value times 10^`scale`, little-endian with no leading zeros.
+  Limbs limbs{};
+  Scale scale{};
+  bool negative{};
+
+  // Removes leading zeros and fixes the sign of zero.
+  void normalize();
+
+  // Adds `other` with its sign flipped if `subtract`.
+  void add(const DecimalLongnum &other, bool subtract);
+};
+
+std::ostream &operator<<(std::ostream &os, const DecimalLongnum &num);
+
+} // namespace ln
+
+template <std::integral T> ln::DecimalLongnum::DecimalLongnum(T other) {
+  using UnsignedT = std::make_unsigned_t<T>;
+
+  negative = other < 0;
+  auto abs_value{negative
+                     ? static_cast<UnsignedT>(-static_cast<UnsignedT>(other))
+                     : static_cast<UnsignedT>(other)};
+  while (abs_value != 0) {
+    limbs.push_back(static_cast<Limb>(abs_value % limb_radix));
+    abs_value = static_cast<UnsignedT>(abs_value / limb_radix);
+  }
+}
+
+#endif
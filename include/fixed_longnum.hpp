@@ -0,0 +1,434 @@
+#ifndef FIXED_LONGNUM_HPP
+#define FIXED_LONGNUM_HPP
+
+#include <array>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "longnum.hpp"
+
+namespace ln {
+
+// A fixed-point type with the layout known at compile time: `IntBits` bits
+// for the integer part, `FracBits` bits for the fraction and a sign bit. The
+// number is kept in two's complement inside a `std::array`, so it never
+// allocates, and all arithmetic is usable in constant expressions.
+//
+// Integer overflow wraps around, like with built-in integers. Fraction bits
+// that don't fit are truncated towards zero, like `Longnum` does.
+template <std::size_t IntBits, std::size_t FracBits> class FixedLongnum {
+public:
+  using Digit = Longnum::Digit;
+  using DoubleDigit = Longnum::DoubleDigit;
+
+  static constexpr auto digit_bits{Longnum::digit_bits};
+
+  // Bits used for a number including the sign bit.
+  static constexpr std::size_t total_bits{IntBits + FracBits + 1};
+
+  // Limbs used for a number.
+  static constexpr std::size_t limb_count{(total_bits + digit_bits - 1) /
+                                          digit_bits};
+
+  // How many bits are used for fraction.
+  static constexpr Longnum::Precision precision{FracBits};
+
+  ~FixedLongnum() = default;
+  constexpr FixedLongnum(const FixedLongnum &other) = default;
+  constexpr FixedLongnum &operator=(const FixedLongnum &other) = default;
+  constexpr FixedLongnum(FixedLongnum &&other) = default;
+  constexpr FixedLongnum &operator=(FixedLongnum &&other) = default;
+
+  // Initialization with 0.
+  constexpr FixedLongnum() = default;
+
+  // Initialization with any primitive integral value.
+  template <std::integral T> constexpr FixedLongnum(T other);
+
+  // Conversion from a `Longnum`.
+  explicit FixedLongnum(const Longnum &other);
+
+  // Conversion to a `Longnum` with precision of `FracBits`.
+  explicit operator Longnum() const;
+
+  // Converts to a string with `fp_digits` decimal places after the floating
+  // point.
+  std::string to_string(std::uint32_t fp_digits) const;
+
+  // Returns an int that:
+  // 1. is 0 if a number is 0.
+  // 2. is negative if a number is negative.
+  // 3. is positive if a number is positive.
+  constexpr int sign() const;
+
+  // The usual spaceship operator, nothing crazy.
+  constexpr std::strong_ordering operator<=>(const FixedLongnum &other) const;
+
+  // Checks if the numbers are equal
+  constexpr bool operator==(const FixedLongnum &other) const = default;
+
+  // Adds two numbers.
+  constexpr FixedLongnum operator+(const FixedLongnum &other) const;
+
+  // Adds two numbers.
+  constexpr FixedLongnum &operator+=(const FixedLongnum &other);
+
+  // Unary minus, just makes a copy with an opposite sign.
+  constexpr FixedLongnum operator-() const;
+
+  // Subtracts one number from another.
+  constexpr FixedLongnum operator-(const FixedLongnum &other) const;
+
+  // Subtracts one number from another.
+  constexpr FixedLongnum &operator-=(const FixedLongnum &other);
+
+  // Multiplies two numbers.
+  constexpr FixedLongnum operator*(const FixedLongnum &other) const;
+
+  // Multiplies two numbers.
+  constexpr FixedLongnum &operator*=(const FixedLongnum &other);
+
+  // Divides one number by another. Throws if `other` is 0.
+  constexpr FixedLongnum operator/(const FixedLongnum &other) const;
+
+  // Divides one number by another. Throws if `other` is 0.
+  constexpr FixedLongnum &operator/=(const FixedLongnum &other);
+
+#ifndef LONGNUM_TEST_PRIVATE
+private:
+#endif
+  using Limbs = std::array<Digit, limb_count>;
+
+  // Two's complement representation of the number times 2^`FracBits`.
+  Limbs limbs{};
+
+  // Sign-extends the number from the sign bit, so that bits over
+  // `total_bits` don't hold garbage.
+  constexpr void normalize();
+
+  // Two's complement negation.
+  static constexpr void negate(Limbs &x);
+
+  // Whether the sign bit is set.
+  static constexpr bool is_negative(const Limbs &x);
+};
+
+} // namespace ln
+
+template <std::size_t IntBits, std::size_t FracBits>
+template <std::integral T>
+constexpr ln::FixedLongnum<IntBits, FracBits>::FixedLongnum(T other) {
+  using UnsignedT = std::make_unsigned_t<T>;
+
+  const bool negative{other < 0};
+  const UnsignedT abs_value{
+      negative ? static_cast<UnsignedT>(-static_cast<UnsignedT>(other))
+               : static_cast<UnsignedT>(other)};
+
+  constexpr auto bits{std::numeric_limits<UnsignedT>::digits};
+  for (std::size_t i{0}; i < bits; i++) {
+    const auto pos{i + FracBits};
+    if (pos < limb_count * digit_bits && ((abs_value >> i) & 1)) {
+      limbs[pos / digit_bits] |= static_cast<Digit>(Digit{1}
+                                                     << (pos % digit_bits));
+    }
+  }
+
+  if (negative) {
+    negate(limbs);
+  }
+  normalize();
+}
+
+template <std::size_t IntBits, std::size_t FracBits>
+ln::FixedLongnum<IntBits, FracBits>::FixedLongnum(const Longnum &other) {
+  Longnum x{other};
+  x.set_precision(precision);
+
+  for (std::size_t i{0}; i < limb_count && i < x.digits.size(); i++) {
+    limbs[i] = x.digits[i];
+  }
+
+  if (x.negative) {
+    negate(limbs);
+  }
+  normalize();
+}
+
+template <std::size_t IntBits, std::size_t FracBits>
+ln::FixedLongnum<IntBits, FracBits>::operator Longnum() const {
+  Limbs abs{limbs};
+  const bool negative{is_negative(abs)};
+  if (negative) {
+    negate(abs);
+  }
+
+  Longnum res{};
+  res.digits = kernels::Digits(abs.begin(), abs.end());
+  res.precision = precision;
+  res.negative = negative;
+  res.remove_leading_zeros();
+  return res;
+}
+
+template <std::size_t IntBits, std::size_t FracBits>
+std::string
+ln::FixedLongnum<IntBits, FracBits>::to_string(std::uint32_t fp_digits) const {
+  return static_cast<Longnum>(*this).to_string(fp_digits);
+}
+
+template <std::size_t IntBits, std::size_t FracBits>
+constexpr int ln::FixedLongnum<IntBits, FracBits>::sign() const {
+  if (is_negative(limbs)) {
+    return -1;
+  }
+  for (auto x : limbs) {
+    if (x != 0) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+template <std::size_t IntBits, std::size_t FracBits>
+constexpr std::strong_ordering
+ln::FixedLongnum<IntBits, FracBits>::operator<=>(
+    const FixedLongnum &other) const {
+  const bool this_neg{is_negative(limbs)};
+  const bool other_neg{is_negative(other.limbs)};
+  if (this_neg != other_neg) {
+    return other_neg <=> this_neg;
+  }
+
+  for (std::size_t i{limb_count}; i-- > 0;) {
+    if (limbs[i] != other.limbs[i]) {
+      return limbs[i] <=> other.limbs[i];
+    }
+  }
+  return std::strong_ordering::equal;
+}
+
+template <std::size_t IntBits, std::size_t FracBits>
+constexpr ln::FixedLongnum<IntBits, FracBits>
+ln::FixedLongnum<IntBits, FracBits>::operator+(
+    const FixedLongnum &other) const {
+  FixedLongnum x{*this};
+  return x += other;
+}
+
+template <std::size_t IntBits, std::size_t FracBits>
+constexpr ln::FixedLongnum<IntBits, FracBits> &
+ln::FixedLongnum<IntBits, FracBits>::operator+=(const FixedLongnum &other) {
+  Digit carry{0};
+  for (std::size_t i{0}; i < limb_count; i++) {
+    DoubleDigit val{carry};
+    val += limbs[i];
+    val += other.limbs[i];
+    limbs[i] = static_cast<Digit>(val);
+    carry = static_cast<Digit>(val >> digit_bits);
+  }
+
+  normalize();
+  return *this;
+}
+
+template <std::size_t IntBits, std::size_t FracBits>
+constexpr ln::FixedLongnum<IntBits, FracBits>
+ln::FixedLongnum<IntBits, FracBits>::operator-() const {
+  FixedLongnum x{*this};
+  negate(x.limbs);
+  x.normalize();
+  return x;
+}
+
+template <std::size_t IntBits, std::size_t FracBits>
+constexpr ln::FixedLongnum<IntBits, FracBits>
+ln::FixedLongnum<IntBits, FracBits>::operator-(
+    const FixedLongnum &other) const {
+  FixedLongnum x{*this};
+  return x -= other;
+}
+
+template <std::size_t IntBits, std::size_t FracBits>
+constexpr ln::FixedLongnum<IntBits, FracBits> &
+ln::FixedLongnum<IntBits, FracBits>::operator-=(const FixedLongnum &other) {
+  Digit borrow{0};
+  for (std::size_t i{0}; i < limb_count; i++) {
+    DoubleDigit val{limbs[i]};
+    val -= other.limbs[i];
+    val -= borrow;
+    limbs[i] = static_cast<Digit>(val);
+    borrow = (val >> digit_bits) ? 1 : 0;
+  }
+
+  normalize();
+  return *this;
+}
+
+template <std::size_t IntBits, std::size_t FracBits>
+constexpr ln::FixedLongnum<IntBits, FracBits>
+ln::FixedLongnum<IntBits, FracBits>::operator*(
+    const FixedLongnum &other) const {
+  FixedLongnum x{*this};
+  return x *= other;
+}
+
+template <std::size_t IntBits, std::size_t FracBits>
+constexpr ln::FixedLongnum<IntBits, FracBits> &
+ln::FixedLongnum<IntBits, FracBits>::operator*=(const FixedLongnum &other) {
+  Limbs a{limbs};
+  Limbs b{other.limbs};
+  const bool negative{is_negative(a) != is_negative(b)};
+  if (is_negative(a)) {
+    negate(a);
+  }
+  if (is_negative(b)) {
+    negate(b);
+  }
+
+  std::array<Digit, 2 * limb_count> prod{};
+  for (std::size_t i{0}; i < limb_count; i++) {
+    DoubleDigit carry{0};
+    for (std::size_t j{0}; j < limb_count; j++) {
+      DoubleDigit val{static_cast<DoubleDigit>(a[i]) * b[j] + prod[i + j] +
+                      carry};
+      prod[i + j] = static_cast<Digit>(val);
+      carry = val >> digit_bits;
+    }
+    prod[i + limb_count] = static_cast<Digit>(carry);
+  }
+
+  // Drop `FracBits` extra fraction bits.
+  constexpr auto limb_shift{FracBits / digit_bits};
+  constexpr auto bit_shift{FracBits % digit_bits};
+  for (std::size_t i{0}; i < limb_count; i++) {
+    Digit lo{prod[i + limb_shift]};
+    Digit hi{i + limb_shift + 1 < prod.size() ? prod[i + limb_shift + 1]
+                                              : Digit{0}};
+    if constexpr (bit_shift == 0) {
+      limbs[i] = lo;
+    } else {
+      limbs[i] = static_cast<Digit>((lo >> bit_shift) |
+                                    (hi << (digit_bits - bit_shift)));
+    }
+  }
+
+  if (negative) {
+    negate(limbs);
+  }
+  normalize();
+  return *this;
+}
+
+template <std::size_t IntBits, std::size_t FracBits>
+constexpr ln::FixedLongnum<IntBits, FracBits>
+ln::FixedLongnum<IntBits, FracBits>::operator/(
+    const FixedLongnum &other) const {
+  FixedLongnum x{*this};
+  return x /= other;
+}
+
+template <std::size_t IntBits, std::size_t FracBits>
+constexpr ln::FixedLongnum<IntBits, FracBits> &
+ln::FixedLongnum<IntBits, FracBits>::operator/=(const FixedLongnum &other) {
+  if (other.sign() == 0) {
+    throw std::invalid_argument("Division by zero is not allowed");
+  }
+
+  Limbs a{limbs};
+  Limbs b{other.limbs};
+  const bool negative{is_negative(a) != is_negative(b)};
+  if (is_negative(a)) {
+    negate(a);
+  }
+  if (is_negative(b)) {
+    negate(b);
+  }
+
+  // Restoring division of |a| * 2^`FracBits` by |b|, one quotient bit at a
+  // time. The remainder is always less than |b|, so one extra limb is enough
+  // to hold it shifted.
+  constexpr auto dividend_bits{limb_count * digit_bits + FracBits};
+  std::array<Digit, limb_count + 1> rem{};
+  Limbs quotient{};
+  for (std::size_t bit{dividend_bits}; bit-- > 0;) {
+    Digit carry{0};
+    if (bit >= FracBits) {
+      const auto src{bit - FracBits};
+      carry = (a[src / digit_bits] >> (src % digit_bits)) & 1;
+    }
+    for (auto &x : rem) {
+      Digit next{static_cast<Digit>(x >> (digit_bits - 1))};
+      x = static_cast<Digit>((x << 1) | carry);
+      carry = next;
+    }
+
+    bool ge{rem[limb_count] != 0};
+    if (!ge) {
+      ge = true;
+      for (std::size_t i{limb_count}; i-- > 0;) {
+        if (rem[i] != b[i]) {
+          ge = rem[i] > b[i];
+          break;
+        }
+      }
+    }
+
+    if (ge) {
+      Digit borrow{0};
+      for (std::size_t i{0}; i <= limb_count; i++) {
+        DoubleDigit val{rem[i]};
+        val -= i < limb_count ? b[i] : Digit{0};
+        val -= borrow;
+        rem[i] = static_cast<Digit>(val);
+        borrow = (val >> digit_bits) ? 1 : 0;
+      }
+      if (bit < limb_count * digit_bits) {
+        quotient[bit / digit_bits] |=
+            static_cast<Digit>(Digit{1} << (bit % digit_bits));
+      }
+    }
+  }
+
+  limbs = quotient;
+  if (negative) {
+    negate(limbs);
+  }
+  normalize();
+  return *this;
+}
+
+template <std::size_t IntBits, std::size_t FracBits>
+constexpr void ln::FixedLongnum<IntBits, FracBits>::normalize() {
+  constexpr auto used_bits{total_bits - (limb_count - 1) * digit_bits};
+  if constexpr (used_bits < digit_bits) {
+    auto &top{limbs[limb_count - 1]};
+    const bool negative{((top >> (used_bits - 1)) & 1) != 0};
+    const Digit mask{
+        static_cast<Digit>(~Digit{0} << static_cast<unsigned>(used_bits))};
+    top = negative ? static_cast<Digit>(top | mask)
+                   : static_cast<Digit>(top & ~mask);
+  }
+}
+
+template <std::size_t IntBits, std::size_t FracBits>
+constexpr void ln::FixedLongnum<IntBits, FracBits>::negate(Limbs &x) {
+  Digit carry{1};
+  for (auto &d : x) {
+    DoubleDigit val{static_cast<DoubleDigit>(static_cast<Digit>(~d)) + carry};
+    d = static_cast<Digit>(val);
+    carry = static_cast<Digit>(val >> digit_bits);
+  }
+}
+
+template <std::size_t IntBits, std::size_t FracBits>
+constexpr bool
+ln::FixedLongnum<IntBits, FracBits>::is_negative(const Limbs &x) {
+  return (x[limb_count - 1] >> (digit_bits - 1)) != 0;
+}
+
+#endif
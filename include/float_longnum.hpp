@@ -0,0 +1,131 @@
+#ifndef FLOAT_LONGNUM_HPP
+#define FLOAT_LONGNUM_HPP
+
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "longnum.hpp"
+
+namespace ln {
+
+// An arbitrary precision floating-point type: an integer mantissa times
+// 2^`exponent`. The mantissa keeps at most `get_bits()` significant bits and
+// no trailing zero bits, so memory and time depend on how many bits are
+// significant, not on how large or small the number is.
+//
+// Results get the largest bit cap of the operands. Bits that don't fit are
+// truncated towards zero, like `Longnum` does.
+class FloatLongnum {
+public:
+  using Digit = Longnum::Digit;
+  using Precision = Longnum::Precision;
+  using Exponent = std::int64_t;
+
+  // Bit cap used when none is given.
+  static constexpr std::size_t default_bits{128};
+
+  ~FloatLongnum() = default;
+  FloatLongnum(const FloatLongnum &other) = default;
+  FloatLongnum &operator=(const FloatLongnum &other) = default;
+  FloatLongnum(FloatLongnum &&other) = default;
+  FloatLongnum &operator=(FloatLongnum &&other) = default;
+
+  // Initialization with 0.
+  FloatLongnum() = default;
+
+  // Initialization with any primitive integral value.
+  template <std::integral T>
+  FloatLongnum(T other, std::size_t bits = default_bits)
+      : FloatLongnum(Longnum(other), bits) {}
+
+  // Conversion from a `Longnum`, keeping `bits` significant bits. Throws if
+  // `bits` is 0.
+  FloatLongnum(const Longnum &other, std::size_t bits = default_bits);
+
+  // Exact conversion to a `Longnum`. Throws if the number needs more bits
+  // for fraction than `Precision` can hold.
+  explicit operator Longnum() const;
+
+  // Converts to a string with `fp_digits` decimal places after the floating
+  // point.
+  std::string to_string(std::uint32_t fp_digits) const;
+
+  // How many significant bits the number may keep.
+  std::size_t get_bits() const;
+
+  // Changes the bit cap, truncating the mantissa if needed. Throws if `bits`
+  // is 0.
+  FloatLongnum &set_bits(std::size_t bits);
+
+  // The number is `mantissa()` * 2^`exponent()`, the mantissa is odd or 0.
+  Longnum mantissa() const;
+  Exponent exponent() const;
+
+  // Returns an int that:
+  // 1. is 0 if a number is 0.
+  // 2. is negative if a number is negative.
+  // 3. is positive if a number is positive.
+  int sign() const;
+
+  // The usual spaceship operator, nothing crazy.
+  std::strong_ordering operator<=>(const FloatLongnum &other) const;
+
+  // Checks if the numbers are equal.
+  bool operator==(const FloatLongnum &other) const;
+
+  // Adds two numbers.
+  FloatLongnum operator+(const FloatLongnum &other) const;
+
+  // Adds two numbers.
+  FloatLongnum &operator+=(const FloatLongnum &other);
+
+  // Unary minus, just makes a copy with an opposite sign.
+  FloatLongnum operator-() const;
+
+  // Subtracts one number from another.
+  FloatLongnum operator-(const FloatLongnum &other) const;
+
+  // Subtracts one number from another.
+  FloatLongnum &operator-=(const FloatLongnum &other);
+
+  // Multiplies two numbers.
+  FloatLongnum operator*(const FloatLongnum &other) const;
+
+  // Multiplies two numbers.
+  FloatLongnum &operator*=(const FloatLongnum &other);
+
+  // Divides one number by another. Throws if `other` is 0.
+  FloatLongnum operator/(const FloatLongnum &other) const;
+
+  // Divides one number by another. Throws if `other` is 0.
+  FloatLongnum &operator/=(const FloatLongnum &other);
+
+#ifndef LONGNUM_TEST_PRIVATE
+private:
+#endif
+  using Digits = std::vector<Digit>;
+
+  // Absolute value of the mantissa, odd or empty.
+  Digits mant{};
+  Exponent exp{};
+  bool negative{};
+  std::size_t bits{default_bits};
+
+  // Truncates `mant` to `bits` significant bits, moves trailing zeros into
+  // `exp`, and fixes the sign of zero.
+  void normalize();
+
+  // Position right after the most significant bit, that is |x| < 2^top.
+  Exponent top() const;
+
+  // Adds `other` with its sign flipped if `subtract`.
+  void add(const FloatLongnum &other, bool subtract);
+};
+
+} // namespace ln
+
+#endif
@@ -1,36 +1,62 @@
 #ifndef LONGNUM_HPP
 #define LONGNUM_HPP
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <cmath>
 #include <compare>
 #include <concepts>
 #include <cstdint>
 #include <cstring>
+#include <istream>
 #include <limits>
+#include <optional>
+#include <ostream>
+#include <ranges>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
+#include "longnum_kernels.hpp"
+#include "shared_digits.hpp"
+
 namespace ln {
 
-// An arbitrary precision fixed-point type.
+struct XgcdResult;
+class WorkingPrecision;
+
+// How results are rounded to the working precision, see `WorkingPrecision`.
+enum class Rounding {
+  // Bits that don't fit are dropped, the way they are without a context.
+  truncate,
+  // To the nearest representable number, ties away from zero.
+  nearest,
+};
+
+// An arbitrary precision fixed-point type. Everything but conversion to text
+// and construction from floating-point values is usable in constant
+// expressions, see `bake` for keeping the results.
 class Longnum {
 public:
-#if defined(__x86_64__) || defined(_WIN64)
-  using Digit = std::uint32_t;
-  using DoubleDigit = std::uint64_t;
-#elif defined(__i386__) || defined(_WIN32)
-  using Digit = std::uint16_t;
-  using DoubleDigit = std::uint32_t;
-#else
-#error "The system is not 64-bit niether 32-bit and therefore not supported"
-#endif
+  using Digit = kernels::Digit;
+  using DoubleDigit = kernels::DoubleDigit;
 
   static constexpr auto digit_bits{std::numeric_limits<Digit>::digits};
 
   using Precision = std::int32_t;
 
+  // Bases that text can be converted from and to bit by bit.
+  enum class Radix {
+    base2 = 2,
+    base4 = 4,
+    base8 = 8,
+    base16 = 16,
+    base32 = 32,
+  };
+
   ~Longnum() = default;
   Longnum(const Longnum &other) = default;
   Longnum &operator=(const Longnum &other) = default;
@@ -38,99 +64,237 @@ public:
   Longnum &operator=(Longnum &&other) = default;
 
   // Initialization with 0 and precision of 0.
-  Longnum();
+  constexpr Longnum();
 
   // Initialization with any primitive integral value and (optionally) given
   // precision.
-  template <std::integral T> Longnum(T other, Precision precision = 0);
+  template <std::integral T>
+  constexpr Longnum(T other, Precision precision = 0);
 
   // Initialization with any primitive floating-point value. Precision is
   // derived from the given number. `other` must be a finite number. Throws
   // if nan or inf given.
   template <std::floating_point T> Longnum(T other);
 
+  // Parses a decimal number like "-123.456" keeping `prec` bits for
+  // fraction. Fraction digits that don't fit are truncated towards zero.
+  // Throws if `str` is not a number or `prec` is negative.
+  static Longnum from_string(std::string_view str, Precision prec = 0);
+
+  // Parses a number like "-ff.8" written in `radix`. Digits above 9 are
+  // letters, either lowercase or uppercase, as in base32hex. Every fraction
+  // digit gives log2(`radix`) bits of precision, so nothing is rounded off.
+  // Takes linear time. Throws if `str` is not a number in `radix`.
+  static Longnum from_string(std::string_view str, Radix radix);
+
   // Converts to a string with `fp_digits` decimal places after the floating
   // point.
   std::string to_string(std::uint32_t fp_digits) const;
 
+  // Converts to a string in `radix`, in the format `from_string` reads. The
+  // value is written exactly, with as many fraction digits as it takes to
+  // hold `precision` bits. Takes linear time.
+  std::string to_string(Radix radix) const;
+
+  // Writes the same text as `to_string(fp_digits)` to `os`. Digits are
+  // produced most significant first and flushed to the stream in fixed-size
+  // chunks, so the whole string is never kept in memory.
+  void write_decimal(std::ostream &os, std::uint32_t fp_digits) const;
+
+  // Writes the number to `os` in a compact binary form that is the same on
+  // every platform: sign, precision, and the absolute value as little-endian
+  // bytes.
+  void write_binary(std::ostream &os) const;
+
+  // Reads a number written by `write_binary`. Throws if the data is truncated
+  // or malformed.
+  static Longnum read_binary(std::istream &is);
+
   // How many bits are needed to represent the absolute value of the number.
-  std::size_t bits_in_absolute_value() const;
+  constexpr std::size_t bits_in_absolute_value() const;
 
   // How many bits are used for fraction.
-  Precision get_precision() const;
+  constexpr Precision get_precision() const;
 
   // Sets how many bits are used for fraction. Keep in mind, it works in O(n).
-  Longnum &set_precision(Precision prec);
+  constexpr Longnum &set_precision(Precision prec);
 
   // Returns an int that:
   // 1. is 0 if a number is 0.
   // 2. is negative if a number is negative.
   // 3. is positive if a number is positive.
-  int sign() const;
+  constexpr int sign() const;
 
   // Same as multiplying the number by -1.
-  Longnum &flip_sign();
+  constexpr Longnum &flip_sign();
 
   // The usual spaceship operator, nothing crazy.
-  std::strong_ordering operator<=>(const Longnum &other) const;
+  constexpr std::strong_ordering operator<=>(const Longnum &other) const;
 
   // Checks if the numbers are equal
-  bool operator==(const Longnum &other) const;
+  constexpr bool operator==(const Longnum &other) const;
 
   // Checks if the numbers are different
-  bool operator!=(const Longnum &other) const;
+  constexpr bool operator!=(const Longnum &other) const;
 
   // Adds two numbers. Max precision of the operands is kept.
-  Longnum operator+(const Longnum &other) const;
+  constexpr Longnum operator+(const Longnum &other) const;
 
   // Adds two numbers. Max precision of the operands is kept.
-  Longnum &operator+=(const Longnum &other);
+  constexpr Longnum &operator+=(const Longnum &other);
 
   // Unary minus, just makes a copy with an opposite sign.
-  Longnum operator-() const;
+  constexpr Longnum operator-() const;
 
   // Subtracts one number from another. Max precision of the operands is kept.
-  Longnum operator-(const Longnum &other) const;
+  constexpr Longnum operator-(const Longnum &other) const;
 
   // Subtracts one number from another. Max precision of the operands is kept.
-  Longnum &operator-=(const Longnum &other);
+  constexpr Longnum &operator-=(const Longnum &other);
 
   // Multiplies two numbers. Max precision of the operands is kept.
-  Longnum operator*(const Longnum &other) const;
+  constexpr Longnum operator*(const Longnum &other) const;
 
   // Multiplies two numbers. Max precision of the operands is kept.
-  Longnum &operator*=(const Longnum &other);
+  constexpr Longnum &operator*=(const Longnum &other);
+
+  // Multiplies by `other` keeping `prec` bits for fraction. Only the limbs
+  // that affect the kept bits are computed, so the result may be 1 unit in
+  // the last place smaller in absolute value than the truncated exact
+  // product.
+  constexpr Longnum &mul_high(const Longnum &other, Precision prec);
 
   // Divides one number by another. Max precision of the operands is kept.
   // Throws if `other` is 0.
-  Longnum operator/(const Longnum &other) const;
+  constexpr Longnum operator/(const Longnum &other) const;
 
   // Divides one number by another. Max precision of the operands is kept.
   // Throws if `other` is 0.
-  Longnum &operator/=(const Longnum &other);
+  constexpr Longnum &operator/=(const Longnum &other);
 
   // One number modulo another. Max precision of the operands is kept.
   // Throws if `other` is 0.
-  Longnum operator%(const Longnum &other) const;
+  constexpr Longnum operator%(const Longnum &other) const;
 
   // One number modulo another. Max precision of the operands is kept.
   // Throws if `other` is 0.
-  Longnum &operator%=(const Longnum &other);
+  constexpr Longnum &operator%=(const Longnum &other);
 
   // Returns both quotient (first) and reminder (second). Max precision of the
   // operands is kept. Throws if `other` is 0.
-  std::pair<Longnum, Longnum> div_mod(const Longnum &other) const;
+  constexpr std::pair<Longnum, Longnum> div_mod(const Longnum &other) const;
+
+  // Overloads for primitive integral operands. They give the same results as
+  // converting `other` to a `Longnum` first, but work on the limbs in place
+  // instead of building one bit by bit. See also the non-member operators
+  // below.
+
+  // Compares with a primitive integral value.
+  template <std::integral T>
+  constexpr std::strong_ordering operator<=>(T other) const;
+
+  // Checks if the number equals a primitive integral value.
+  template <std::integral T> constexpr bool operator==(T other) const;
+
+  // Adds a primitive integral value.
+  template <std::integral T> constexpr Longnum &operator+=(T other);
+
+  // Subtracts a primitive integral value.
+  template <std::integral T> constexpr Longnum &operator-=(T other);
+
+  // Multiplies by a primitive integral value.
+  template <std::integral T> constexpr Longnum &operator*=(T other);
+
+  // Divides by a primitive integral value. Throws if `other` is 0.
+  template <std::integral T> constexpr Longnum &operator/=(T other);
+
+  // Takes modulo a primitive integral value. Throws if `other` is 0.
+  template <std::integral T> constexpr Longnum &operator%=(T other);
+
+  // Bitshift to the left. Works the same as multiplying by 2^`sh`, precision
+  // is kept.
+  constexpr Longnum operator<<(std::size_t sh) const;
+
+  // Bitshift to the left. Works the same as multiplying by 2^`sh`, precision
+  // is kept.
+  constexpr Longnum &operator<<=(std::size_t sh);
+
+  // Bitshift to the right. Works the same as dividing by 2^`sh`, precision is
+  // kept and the result is truncated towards zero.
+  constexpr Longnum operator>>(std::size_t sh) const;
+
+  // Bitshift to the right. Works the same as dividing by 2^`sh`, precision is
+  // kept and the result is truncated towards zero.
+  constexpr Longnum &operator>>=(std::size_t sh);
+
+  // Bitwise operations work on two's complement representations, infinitely
+  // extended with the sign bit to the left, like with built-in integers. Bits
+  // are aligned at the binary point and max precision of the operands is
+  // kept.
+
+  // Bitwise and.
+  constexpr Longnum operator&(const Longnum &other) const;
+
+  // Bitwise and.
+  constexpr Longnum &operator&=(const Longnum &other);
+
+  // Bitwise or.
+  constexpr Longnum operator|(const Longnum &other) const;
+
+  // Bitwise or.
+  constexpr Longnum &operator|=(const Longnum &other);
+
+  // Bitwise xor.
+  constexpr Longnum operator^(const Longnum &other) const;
+
+  // Bitwise xor.
+  constexpr Longnum &operator^=(const Longnum &other);
+
+  // Bit at `index` of the two's complement representation. Non-negative
+  // indices are integer bits, negative ones are fraction bits.
+  constexpr bool test_bit(std::intmax_t index) const;
+
+  // How many bits of the absolute value are set.
+  constexpr std::size_t popcount() const;
+
+  // Index of the lowest set bit, the same for the absolute value and for the
+  // two's complement. Negative for fraction bits. Throws if the number is 0.
+  constexpr std::intmax_t countr_zero() const;
 
 #ifndef LONGNUM_TEST_PRIVATE
 private:
 #endif
+  friend class Accumulator;
+  friend class DecimalLongnum;
+  friend class LongnumArray;
+  friend class Ball;
+  friend class FloatLongnum;
+  friend class MappedLongnum;
+  friend class ModContext;
+  template <std::size_t IntBits, std::size_t FracBits>
+  friend class FixedLongnum;
+  template <std::size_t N> friend struct LongnumLiteral;
+  template <auto generator> friend consteval auto bake();
+  friend constexpr Longnum div(const Longnum &a, const Longnum &b,
+                               Precision prec);
+  friend constexpr Longnum pow(const Longnum &x, std::uint64_t n);
+  friend constexpr Longnum pow(const Longnum &x, std::int64_t n,
+                               Precision prec);
+  friend constexpr Longnum ldexp(Longnum x, std::int64_t exp);
+  friend constexpr Longnum operator+(Longnum &&a, Longnum &&b);
+  friend constexpr Longnum operator-(Longnum &&a, Longnum &&b);
+  friend constexpr Longnum operator*(Longnum &&a, Longnum &&b);
+  friend Longnum gcd(const Longnum &a, const Longnum &b);
+  friend XgcdResult xgcd(const Longnum &a, const Longnum &b);
+
   // A number is represented with three values:
   //
   // 1. `digits` contains a sequence of limbs and represent an absolute value
   //    of a number. Works pretty much as a veeeery big uint. In order for
   //    stuff to work, for time to be saved, and memory not to be spared, there
   //    should be no leading zeros (e. g. zero is an empty vector and some
-  //    functionality might want to rely on this property).
+  //    functionality might want to rely on this property). Copies of a number
+  //    share the limbs until one of them writes to them, see `SharedDigits`.
   //
   // 2. `precision` is opposite of log2 of the difference between the two
   //    closest representable numbers.
@@ -139,65 +303,238 @@ private:
   //
   // 3. `negative`, well, shows if a number is negative or non-negative.
 
-  std::vector<Digit> digits{};
+  SharedDigits digits{};
   Precision precision{};
   bool negative{};
 
   // Compares absolute values of two numbers.
-  std::strong_ordering abs_compare(const Longnum &other) const;
+  constexpr std::strong_ordering abs_compare(const Longnum &other) const;
 
   // If numbers have different precisions, increases the smaller one to make
   // them the same.
-  void align_with(Longnum &other);
+  constexpr void align_with(Longnum &other);
+
+  // How many limbs the number can hold without reallocation if written in
+  // place, 0 if its limbs are shared and would be copied anyway.
+  constexpr std::size_t reusable_capacity() const;
 
   // Removes leading zeros. Needed to save memory and handle zero.
-  void remove_leading_zeros();
+  constexpr void remove_leading_zeros();
+
+  // The working precision context of the current thread, nullptr if there
+  // is none or during constant evaluation.
+  static constexpr const WorkingPrecision *context();
+
+  // Changes precision to `prec`, rounding as `rounding` says.
+  constexpr void round(Precision prec, Rounding rounding);
+
+  // Quotient of absolute values with `prec` bits for fraction, rounded
+  // towards zero and given the sign of the exact quotient. `exact` is set to
+  // whether nothing was rounded off. Throws if `other` is 0.
+  constexpr Longnum truncated_quotient(const Longnum &other, Precision prec,
+                                       bool &exact) const;
 
-  // Bitshift to the left. Works the same as multiplying by 2^`sh`.
-  Longnum operator<<(std::size_t sh) const;
+  // Multiplies by `other` keeping `prec` bits for fraction. Low limbs that
+  // are truncated anyway are skipped. If `exact`, the result is checked and
+  // recomputed with the full product when skipped limbs could carry into the
+  // kept ones.
+  constexpr void mul_to_precision(const Longnum &other, Precision prec,
+                                  bool exact);
 
-  // Bitshift to the left. Works the same as multiplying by 2^`sh`.
-  Longnum &operator<<=(std::size_t sh);
+  // `*this`^`n` by left-to-right sliding window exponentiation. Every
+  // product keeps `prec` bits for fraction if `truncate`, or all of them
+  // otherwise. `n` must not be 0.
+  constexpr Longnum power(std::uint64_t n, Precision prec,
+                          bool truncate) const;
 
-  // Bitshift to the right. Works the same as dividing by 2^`sh`.
-  Longnum operator>>(std::size_t sh) const;
+  // Applies `op` to every limb of the two's complement representations of
+  // `*this` and `other`, see `operator&`.
+  template <class Op>
+  constexpr Longnum bitwise(const Longnum &other, Op op) const;
 
-  // Bitshift to the right. Works the same as dividing by 2^`sh`.
-  Longnum &operator>>=(std::size_t sh);
+  // If the absolute value is a power of two, returns the index of its only
+  // set bit in `digits`. Returns -1 otherwise.
+  constexpr std::intmax_t single_bit() const;
+
+  // Absolute value of a primitive integral value.
+  template <std::integral T>
+  static constexpr std::uintmax_t magnitude(T value);
+
+  // `value` as limbs.
+  static constexpr kernels::Digits to_digits(std::uintmax_t value);
+
+  // Adds `value`, negated if `value_negative`, in place. Precision must be
+  // non-negative.
+  constexpr void add_integral(std::uintmax_t value, bool value_negative);
 
   // Get `i`'th digit in radix 2^`digit_bits`.
-  Digit get_digit(std::intmax_t index) const;
+  constexpr Digit get_digit(std::intmax_t index) const;
 
   // Set `i`'th digit in radix 2^`digit_bits`.
-  void set_digit(std::intmax_t index, Digit digit, bool remove_zeros = false);
+  constexpr void set_digit(std::intmax_t index, Digit digit,
+                           bool remove_zeros = false);
 
   // Max place in radix 2^`digit_bits`.
-  std::intmax_t max_digit_index() const;
+  constexpr std::intmax_t max_digit_index() const;
 
   // Min place in radix 2^`digit_bits`.
-  std::intmax_t min_digit_index() const;
+  constexpr std::intmax_t min_digit_index() const;
 
   // Get `i`'th digit in radix 2.
-  bool get_bit(std::intmax_t index) const;
+  constexpr bool get_bit(std::intmax_t index) const;
 
   // Set `i`'th digit in radix 2.
-  void set_bit(std::intmax_t index, bool bit, bool remove_zeros = false);
+  constexpr void set_bit(std::intmax_t index, bool bit,
+                         bool remove_zeros = false);
+};
+
+// Divides `a` by `b` keeping `prec` bits for fraction. The quotient is
+// rounded towards zero. Only the quotient limbs that are kept get computed and
+// no remainder is made, so it's cheaper than `/` and `div_mod`. Throws if `b`
+// is 0.
+constexpr Longnum div(const Longnum &a, const Longnum &b,
+                      Longnum::Precision prec);
+
+// Raises `x` to the power of `n` exactly, the result has `n` times as many
+// bits for fraction as `x`. Uses left-to-right sliding window
+// exponentiation, and powers of two are just shifted.
+constexpr Longnum pow(const Longnum &x, std::uint64_t n);
+
+// Raises `x` to the power of `n` keeping `prec` bits for fraction in every
+// intermediate product, so each product is truncated the same way `*` does
+// it. Negative `n` divides 1 once by the exact power, so the result is
+// 1 / x^|n| truncated to `prec` bits. Throws if `x` is 0 and `n` is negative,
+// or if the exact power needs a precision that doesn't fit.
+constexpr Longnum pow(const Longnum &x, std::int64_t n,
+                      Longnum::Precision prec);
+
+// Multiplies `x` by 2^`exp` exactly by changing its precision only, the
+// limbs are kept as they are. Throws if the precision goes out of the range
+// of `Longnum::Precision`.
+constexpr Longnum ldexp(Longnum x, std::int64_t exp);
+
+// Same as the member operators, but the result is computed in place of an
+// operand that is about to be destroyed, so no limbs are copied. `+` and `*`
+// reuse either operand, `-` reuses the right one by computing -(`b` - `a`).
+// If both operands are temporaries, the one with more room is taken.
+constexpr Longnum operator+(Longnum &&a, const Longnum &b);
+constexpr Longnum operator+(const Longnum &a, Longnum &&b);
+constexpr Longnum operator+(Longnum &&a, Longnum &&b);
+constexpr Longnum operator-(Longnum &&x);
+constexpr Longnum operator-(Longnum &&a, const Longnum &b);
+constexpr Longnum operator-(const Longnum &a, Longnum &&b);
+constexpr Longnum operator-(Longnum &&a, Longnum &&b);
+constexpr Longnum operator*(Longnum &&a, const Longnum &b);
+constexpr Longnum operator*(const Longnum &a, Longnum &&b);
+constexpr Longnum operator*(Longnum &&a, Longnum &&b);
+
+// Arithmetic with a primitive integral operand on either side. The number is
+// taken by value, so temporaries are reused, and the work is done by the
+// compound assignments for primitive integral values.
+template <std::integral T> constexpr Longnum operator+(Longnum a, T b);
+template <std::integral T> constexpr Longnum operator+(T a, Longnum b);
+template <std::integral T> constexpr Longnum operator-(Longnum a, T b);
+template <std::integral T> constexpr Longnum operator-(T a, Longnum b);
+template <std::integral T> constexpr Longnum operator*(Longnum a, T b);
+template <std::integral T> constexpr Longnum operator*(T a, Longnum b);
+template <std::integral T> constexpr Longnum operator/(Longnum a, T b);
+template <std::integral T> constexpr Longnum operator/(T a, const Longnum &b);
+template <std::integral T> constexpr Longnum operator%(Longnum a, T b);
+template <std::integral T> constexpr Longnum operator%(T a, const Longnum &b);
+
+// Sets the working precision of the current thread for its lifetime, like
+// `workdps` of mpmath. Inside, +, -, *, / and their compound forms, including
+// the ones with primitive integral operands, give results with `prec` bits
+// for fraction rounded as `rounding` says, instead of keeping max precision
+// of the operands. Products and quotients compute only the limbs the result
+// needs.
+//
+// Contexts nest, the innermost one is used, and they must be destroyed in
+// the reverse order of construction, as scoped objects are. Operations that
+// take a precision, like `div` or `set_precision`, `div_mod` and `%`, and
+// everything done during constant evaluation ignore the context. So do the
+// library's computations that rely on exact results, like `Ball` and `Real`
+// arithmetic, `xgcd` and binary splitting.
+class WorkingPrecision {
+public:
+  // Makes `prec` the working precision. Throws if rounding to nearest is
+  // asked for with the max `Precision`, as one more bit is computed then.
+  explicit WorkingPrecision(Longnum::Precision prec,
+                            Rounding rounding = Rounding::truncate);
+
+  ~WorkingPrecision();
+  WorkingPrecision(const WorkingPrecision &other) = delete;
+  WorkingPrecision &operator=(const WorkingPrecision &other) = delete;
+
+  // The innermost context of the current thread, nullptr if there is none.
+  static const WorkingPrecision *current();
+
+  Longnum::Precision get_precision() const;
+  Rounding get_rounding() const;
+
+  // Suspends the context of the current thread for its lifetime, so that
+  // operations are done as without one.
+  class Suspend {
+  public:
+    constexpr Suspend();
+    constexpr ~Suspend();
+    Suspend(const Suspend &other) = delete;
+    Suspend &operator=(const Suspend &other) = delete;
+
+  private:
+    const WorkingPrecision *saved{};
+  };
+
+#ifndef LONGNUM_TEST_PRIVATE
+private:
+#endif
+  Longnum::Precision precision{};
+  Rounding rounding{};
+
+  // The context that was innermost before this one.
+  const WorkingPrecision *previous{};
+
+  static inline thread_local const WorkingPrecision *innermost{nullptr};
+
+  friend class Longnum;
 };
 
+// A `Longnum` frozen into a fixed-size array, so that it can be kept in a
+// constexpr variable and end up in the binary. Made by `bake`.
+template <std::size_t N> struct LongnumLiteral {
+  std::array<Longnum::Digit, N> digits{};
+  Longnum::Precision precision{};
+  bool negative{};
+
+  // Makes a regular `Longnum` out of the literal, copies `N` limbs.
+  constexpr operator Longnum() const;
+};
+
+// Evaluates `generator()` at compile time and returns the result as a
+// `LongnumLiteral`. For example:
+//
+//   constexpr auto third{ln::bake<[] { return ln::Longnum(1, 64) / 3; }>()};
+//   ln::Longnum x{third};
+template <auto generator> consteval auto bake();
+
+// Writes `num` with `os.precision()` decimal places, like `std::fixed` does
+// for floating-point numbers.
+std::ostream &operator<<(std::ostream &os, const Longnum &num);
+
 namespace lits {
 
 // Constructs a number using Longnum(long double).
 Longnum operator""_longnum(long double other);
 
 // Constructs a number using Longnum(unsigned long long).
-Longnum operator""_longnum(unsigned long long other);
+constexpr Longnum operator""_longnum(unsigned long long other);
 
 } // namespace lits
 
 } // namespace ln
 
 template <std::integral T>
-ln::Longnum::Longnum(T other, Precision precision)
+constexpr ln::Longnum::Longnum(T other, Precision precision)
     : precision{precision}, negative{other < 0} {
   using UnsignedT = std::make_unsigned_t<T>;
 
@@ -238,4 +575,1387 @@ ln::Longnum::Longnum(T other) : negative{std::signbit(other)} {
   remove_leading_zeros();
 }
 
+constexpr ln::Longnum::Longnum() : digits{}, precision{0}, negative{false} {}
+
+constexpr std::size_t ln::Longnum::bits_in_absolute_value() const {
+  return sign() == 0
+             ? 0
+             : digits.size() * digit_bits - std::countl_zero(digits.back());
+}
+
+constexpr ln::Longnum::Precision ln::Longnum::get_precision() const {
+  return precision;
+}
+
+constexpr ln::Longnum &ln::Longnum::set_precision(Precision new_prec) {
+  auto old_prec{get_precision()};
+  if (new_prec == old_prec) {
+    return *this;
+  }
+
+  if (new_prec > old_prec) {
+    *this <<= (new_prec - old_prec);
+  } else {
+    *this >>= (old_prec - new_prec);
+  }
+
+  precision = new_prec;
+  remove_leading_zeros();
+  return *this;
+}
+
+constexpr int ln::Longnum::sign() const {
+  if (digits.empty()) {
+    return 0;
+  }
+  return negative ? -1 : 1;
+}
+
+constexpr ln::Longnum &ln::Longnum::flip_sign() {
+  if (sign() != 0) {
+    negative = !negative;
+  }
+  return *this;
+}
+
+constexpr std::strong_ordering
+ln::Longnum::operator<=>(const Longnum &other) const {
+  auto this_sign{sign()};
+  auto other_sign{other.sign()};
+
+  if (this_sign != other_sign) {
+    return this_sign <=> other_sign;
+  }
+
+  auto cmp{abs_compare(other)};
+  return this_sign >= 0 ? cmp : 0 <=> cmp;
+}
+
+constexpr std::strong_ordering
+ln::Longnum::abs_compare(const Longnum &other) const {
+  auto this_bits{bits_in_absolute_value()};
+  auto other_bits{other.bits_in_absolute_value()};
+
+  auto this_prec{get_precision()};
+  auto other_prec{other.get_precision()};
+
+  auto this_msb{static_cast<std::intmax_t>(this_bits) - this_prec};
+  auto other_msb{static_cast<std::intmax_t>(other_bits) - other_prec};
+  if (this_msb != other_msb) {
+    return this_msb <=> other_msb;
+  }
+
+  auto max_digit{std::max(max_digit_index(), other.max_digit_index())};
+  auto min_digit{std::min(min_digit_index(), other.min_digit_index())};
+  for (std::intmax_t i{max_digit}; i >= min_digit; i--) {
+    auto x{this->get_digit(i)};
+    auto y{other.get_digit(i)};
+    if (x != y) {
+      return x <=> y;
+    }
+  }
+
+  return std::strong_ordering::equal;
+}
+
+constexpr bool ln::Longnum::operator==(const Longnum &other) const {
+  return (*this <=> other) == 0;
+}
+
+constexpr bool ln::Longnum::operator!=(const Longnum &other) const {
+  return !(*this == other);
+}
+
+constexpr void ln::Longnum::align_with(Longnum &other) {
+  const auto this_precision{get_precision()};
+  const auto other_precision{other.get_precision()};
+
+  if (this_precision < other_precision) {
+    this->set_precision(other_precision);
+  } else {
+    other.set_precision(this_precision);
+  }
+}
+
+constexpr std::size_t ln::Longnum::reusable_capacity() const {
+  return digits.shared() ? 0 : digits.get().capacity();
+}
+
+constexpr void ln::Longnum::remove_leading_zeros() {
+  while (sign() != 0 && digits.back() == 0) {
+    digits.unshared().pop_back();
+  }
+  if (sign() == 0) {
+    negative = false;
+  }
+}
+
+constexpr const ln::WorkingPrecision *ln::Longnum::context() {
+  if (std::is_constant_evaluated()) {
+    return nullptr;
+  }
+  return WorkingPrecision::innermost;
+}
+
+constexpr void ln::Longnum::round(Precision prec, Rounding rounding) {
+  // The first dropped bit is worth half of the last kept one.
+  const bool up{rounding == Rounding::nearest && get_precision() > prec &&
+                get_bit(-static_cast<std::intmax_t>(prec) - 1)};
+  const bool was_negative{negative};
+  set_precision(prec);
+  if (up) {
+    digits = kernels::add(digits, kernels::Digits{1});
+    negative = was_negative;
+  }
+}
+
+constexpr ln::WorkingPrecision::Suspend::Suspend() {
+  if (!std::is_constant_evaluated()) {
+    saved = std::exchange(innermost, nullptr);
+  }
+}
+
+constexpr ln::WorkingPrecision::Suspend::~Suspend() {
+  if (!std::is_constant_evaluated()) {
+    innermost = saved;
+  }
+}
+
+constexpr ln::Longnum ln::Longnum::operator<<(std::size_t sh) const {
+  Longnum x{*this};
+  return x <<= sh;
+}
+
+constexpr ln::Longnum &ln::Longnum::operator<<=(std::size_t sh) {
+  if (sign() == 0) {
+    return *this;
+  }
+
+  const auto full_digits{sh / digit_bits};
+
+  auto &limbs{digits.unshared()};
+  limbs.insert(limbs.begin(), full_digits, 0);
+
+  sh %= digit_bits;
+  if (sh == 0) {
+    return *this;
+  }
+
+  Digit carry{0};
+  for (auto &curr : limbs) {
+    Digit shifted{static_cast<Digit>((curr << sh) | carry)};
+    carry = curr >> (digit_bits - sh);
+    curr = shifted;
+  }
+
+  if (carry != 0) {
+    limbs.push_back(carry);
+  }
+
+  remove_leading_zeros();
+  return *this;
+}
+
+constexpr ln::Longnum ln::Longnum::operator>>(std::size_t sh) const {
+  Longnum x{*this};
+  return x >>= sh;
+}
+
+constexpr ln::Longnum &ln::Longnum::operator>>=(std::size_t sh) {
+  if (sign() == 0) {
+    return *this;
+  }
+
+  const auto full_digits{sh / digit_bits};
+  if (full_digits >= digits.size()) {
+    return (*this = Longnum(0));
+  }
+
+  auto &limbs{digits.unshared()};
+  limbs.erase(limbs.begin(), limbs.begin() + full_digits);
+
+  sh %= digit_bits;
+  if (sh == 0) {
+    return *this;
+  }
+
+  Digit carry{0};
+  for (auto &curr : std::ranges::reverse_view(limbs)) {
+    Digit shifted{static_cast<Digit>((curr >> sh) | carry)};
+    carry = curr << (digit_bits - sh);
+    curr = shifted;
+  }
+
+  remove_leading_zeros();
+  return *this;
+}
+
+constexpr ln::Longnum::Digit ln::Longnum::get_digit(std::intmax_t index) const {
+  if (get_precision() % digit_bits == 0) {
+    index += get_precision() / digit_bits;
+    return (index >= 0 && static_cast<std::size_t>(index) < digits.size())
+               ? digits[index]
+               : 0;
+  }
+
+  index = index * digit_bits + get_precision();
+
+  Digit lo{0};
+  if (index >= 0 &&
+      static_cast<std::size_t>(index / digit_bits) < digits.size()) {
+    lo = digits[index / digit_bits];
+  }
+
+  index += digit_bits;
+
+  Digit hi{0};
+  if (index >= 0 &&
+      static_cast<std::size_t>(index / digit_bits) < digits.size()) {
+    hi = digits[index / digit_bits];
+  }
+
+  auto shift{(get_precision()) % digit_bits};
+  if (shift < 0) {
+    shift += digit_bits;
+  }
+
+  return (hi << (digit_bits - shift)) | (lo >> shift);
+}
+
+constexpr void ln::Longnum::set_digit(std::intmax_t index, Digit digit,
+                                      bool remove_zeros) {
+  if (get_precision() % digit_bits == 0) {
+    index += get_precision() / digit_bits;
+    if (index >= 0) {
+      auto &limbs{digits.unshared()};
+      limbs.resize(std::max(static_cast<std::size_t>(index + 1), limbs.size()),
+                   0);
+      limbs[index] = digit;
+    }
+    return;
+  }
+
+  auto shift{(get_precision()) % digit_bits};
+  if (shift < 0) {
+    shift += digit_bits;
+  }
+
+  Digit lo{static_cast<Digit>(digit << shift)};
+  Digit hi{static_cast<Digit>(digit >> (digit_bits - shift))};
+
+  index = index * digit_bits + get_precision();
+
+  Digit mx{std::numeric_limits<Digit>::max()};
+
+  if (index >= 0) {
+    index /= digit_bits;
+    auto &limbs{digits.unshared()};
+    limbs.resize(std::max(static_cast<std::size_t>(index + 2), limbs.size()),
+                 0);
+
+    limbs[index] = (limbs[index] & (mx >> (digit_bits - shift))) | lo;
+
+    index++;
+
+    limbs[index] = (limbs[index] & (mx << shift)) | hi;
+  } else if ((index += digit_bits) >= 0) {
+    index /= digit_bits;
+    auto &limbs{digits.unshared()};
+    limbs.resize(std::max(static_cast<std::size_t>(index + 1), limbs.size()),
+                 0);
+
+    limbs[index] = (limbs[index] & (mx << shift)) | hi;
+  }
+
+  if (remove_zeros) {
+    remove_leading_zeros();
+  }
+}
+
+constexpr std::intmax_t ln::Longnum::max_digit_index() const {
+  if (sign() == 0) {
+    return std::numeric_limits<std::intmax_t>::min();
+  }
+
+  std::intmax_t max_bit{static_cast<std::intmax_t>(bits_in_absolute_value()) -
+                        get_precision()};
+
+  if (max_bit >= 0 || max_bit % digit_bits == 0) {
+    return max_bit / digit_bits;
+  }
+
+  return max_bit / digit_bits - 1;
+}
+
+constexpr std::intmax_t ln::Longnum::min_digit_index() const {
+  if (sign() == 0) {
+    return std::numeric_limits<std::intmax_t>::max();
+  }
+
+  std::intmax_t min_bit{-get_precision()};
+
+  if (min_bit >= 0 || min_bit % digit_bits == 0) {
+    return min_bit / digit_bits;
+  }
+
+  return min_bit / digit_bits - 1;
+}
+
+constexpr bool ln::Longnum::get_bit(std::intmax_t index) const {
+  const auto real_index{index + get_precision()};
+  if (real_index < 0 ||
+      static_cast<std::size_t>(real_index) / digit_bits >= digits.size()) {
+    return false;
+  }
+  return (digits[real_index / digit_bits] >> (real_index % digit_bits)) & 0x1;
+}
+
+constexpr void ln::Longnum::set_bit(std::intmax_t index, bool bit,
+                                    bool remove_zeros) {
+  auto real_index{index + get_precision()};
+
+  if (real_index < 0) {
+    return;
+  }
+
+  const auto digits_needed{(real_index + digit_bits - 1) / digit_bits + 1};
+  auto &limbs{digits.unshared()};
+  limbs.resize(std::max(limbs.size(), static_cast<std::size_t>(digits_needed)),
+               0);
+
+  Digit &val{limbs[real_index / digit_bits]};
+  if (bit) {
+    val |= static_cast<Digit>(1) << (real_index % digit_bits);
+  } else {
+    val &= ~(static_cast<Digit>(1) << (real_index % digit_bits));
+  }
+
+  if (remove_zeros) {
+    remove_leading_zeros();
+  }
+}
+
+template <class Op>
+constexpr ln::Longnum ln::Longnum::bitwise(const Longnum &other,
+                                           Op op) const {
+  const auto prec{std::max(get_precision(), other.get_precision())};
+  Longnum x{*this};
+  Longnum y{other};
+  x.set_precision(prec);
+  y.set_precision(prec);
+
+  // One more limb than the longer operand takes is enough for the sign bit
+  // of both and of the result.
+  const auto n{std::max(x.digits.size(), y.digits.size()) + 1};
+  auto negate{[](kernels::Digits &v) {
+    Digit carry{1};
+    for (auto &d : v) {
+      DoubleDigit val{static_cast<DoubleDigit>(static_cast<Digit>(~d)) +
+                      carry};
+      d = static_cast<Digit>(val);
+      carry = static_cast<Digit>(val >> digit_bits);
+    }
+  }};
+  auto twos{[n, &negate](const Longnum &v) {
+    kernels::Digits res(v.digits.begin(), v.digits.end());
+    res.resize(n, 0);
+    if (v.negative) {
+      negate(res);
+    }
+    return res;
+  }};
+
+  auto res{twos(x)};
+  const auto rhs{twos(y)};
+  for (std::size_t i{0}; i < n; i++) {
+    res[i] = op(res[i], rhs[i]);
+  }
+
+  Longnum out{};
+  out.negative = (res.back() >> (digit_bits - 1)) != 0;
+  if (out.negative) {
+    negate(res);
+  }
+  out.digits = std::move(res);
+  out.precision = prec;
+  out.remove_leading_zeros();
+  return out;
+}
+
+constexpr ln::Longnum ln::Longnum::operator&(const Longnum &other) const {
+  return bitwise(other, [](Digit a, Digit b) { return a & b; });
+}
+
+constexpr ln::Longnum &ln::Longnum::operator&=(const Longnum &other) {
+  return *this = *this & other;
+}
+
+constexpr ln::Longnum ln::Longnum::operator|(const Longnum &other) const {
+  return bitwise(other, [](Digit a, Digit b) { return a | b; });
+}
+
+constexpr ln::Longnum &ln::Longnum::operator|=(const Longnum &other) {
+  return *this = *this | other;
+}
+
+constexpr ln::Longnum ln::Longnum::operator^(const Longnum &other) const {
+  return bitwise(other, [](Digit a, Digit b) { return a ^ b; });
+}
+
+constexpr ln::Longnum &ln::Longnum::operator^=(const Longnum &other) {
+  return *this = *this ^ other;
+}
+
+constexpr bool ln::Longnum::test_bit(std::intmax_t index) const {
+  if (!negative) {
+    return get_bit(index);
+  }
+
+  // -m is ~(m - 1): bits below the lowest set bit of m stay 0, that bit
+  // stays 1 and all the bits above it are flipped.
+  const auto lowest{countr_zero()};
+  if (index <= lowest) {
+    return index == lowest;
+  }
+  return !get_bit(index);
+}
+
+constexpr std::size_t ln::Longnum::popcount() const {
+  std::size_t res{0};
+  for (auto d : digits) {
+    res += static_cast<std::size_t>(std::popcount(d));
+  }
+  return res;
+}
+
+constexpr std::intmax_t ln::Longnum::countr_zero() const {
+  if (sign() == 0) {
+    throw std::invalid_argument("Zero has no set bits");
+  }
+
+  std::size_t i{0};
+  while (digits[i] == 0) {
+    i++;
+  }
+  return static_cast<std::intmax_t>(i * digit_bits) +
+         std::countr_zero(digits[i]) - get_precision();
+}
+
+constexpr ln::Longnum ln::Longnum::operator+(const Longnum &other) const {
+  Longnum x{*this};
+  return x += other;
+}
+
+constexpr ln::Longnum &ln::Longnum::operator+=(const Longnum &other) {
+  if (const auto *ctx{context()}) {
+    WorkingPrecision::Suspend exact{};
+    *this += other;
+    round(ctx->get_precision(), ctx->get_rounding());
+    return *this;
+  }
+
+  if (other.sign() == 0) {
+    return *this;
+  }
+
+  if (sign() == 0) {
+    return *this = other;
+  }
+
+  if (sign() != other.sign()) {
+    flip_sign();
+    *this -= other;
+    flip_sign();
+    return *this;
+  }
+
+  set_precision(std::max(get_precision(), other.get_precision()));
+
+  Digit carry{0};
+
+  auto start{min_digit_index()};
+  auto end{std::max(max_digit_index(), other.max_digit_index())};
+  for (std::intmax_t i{start}; i <= end; i++) {
+    DoubleDigit val{carry};
+    val += get_digit(i);
+    val += other.get_digit(i);
+
+    set_digit(i, static_cast<Digit>(val));
+    carry = val >> digit_bits;
+  }
+
+  remove_leading_zeros();
+  return *this;
+}
+
+constexpr ln::Longnum ln::Longnum::operator-() const {
+  Longnum x{*this};
+  return x.flip_sign();
+}
+
+constexpr ln::Longnum ln::Longnum::operator-(const Longnum &other) const {
+  Longnum x{*this};
+  return x -= other;
+}
+
+constexpr ln::Longnum &ln::Longnum::operator-=(const Longnum &other) {
+  if (const auto *ctx{context()}) {
+    WorkingPrecision::Suspend exact{};
+    *this -= other;
+    round(ctx->get_precision(), ctx->get_rounding());
+    return *this;
+  }
+
+  if (other.sign() == 0) {
+    return *this;
+  }
+
+  if (sign() == 0) {
+    return *this = -other;
+  }
+
+  if (sign() != other.sign()) {
+    flip_sign();
+    *this += other;
+    flip_sign();
+    return *this;
+  }
+
+  set_precision(std::max(get_precision(), other.get_precision()));
+
+  auto cmp = abs_compare(other);
+  if (cmp == 0) {
+    digits = SharedDigits{};
+    negative = false;
+    return *this;
+  }
+
+  if (cmp < 0) {
+    flip_sign();
+  }
+
+  Digit borrow{0};
+
+  auto start{min_digit_index()};
+  auto end{std::max(max_digit_index(), other.max_digit_index())};
+  for (std::intmax_t i{start}; i <= end; i++) {
+    DoubleDigit val{cmp > 0 ? get_digit(i) : other.get_digit(i)};
+    val -= cmp > 0 ? other.get_digit(i) : get_digit(i);
+    val -= borrow;
+
+    set_digit(i, static_cast<Digit>(val));
+    borrow = (val >> digit_bits) ? 1 : 0;
+  }
+
+  remove_leading_zeros();
+  return *this;
+}
+
+constexpr ln::Longnum ln::Longnum::operator*(const Longnum &other) const {
+  Longnum x{*this};
+  return x *= other;
+}
+
+constexpr ln::Longnum &ln::Longnum::operator*=(const Longnum &other) {
+  if (const auto *ctx{context()}) {
+    // One more bit tells which way to round to nearest.
+    const auto prec{ctx->get_precision()};
+    const bool nearest{ctx->get_rounding() == Rounding::nearest};
+    mul_to_precision(other, nearest ? prec + 1 : prec, true);
+    round(prec, ctx->get_rounding());
+    return *this;
+  }
+
+  mul_to_precision(other, std::max(get_precision(), other.get_precision()),
+                   true);
+  return *this;
+}
+
+constexpr ln::Longnum ln::Longnum::truncated_quotient(const Longnum &other,
+                                                     Precision prec,
+                                                     bool &exact) const {
+  if (other.sign() == 0) {
+    throw std::invalid_argument("Division by zero is not allowed");
+  }
+
+  Longnum res{};
+  res.precision = prec;
+  exact = true;
+  if (sign() == 0) {
+    return res;
+  }
+
+  // |q| = floor(`digits` * 2^`shift` / `other.digits`)
+  const auto shift{static_cast<std::intmax_t>(prec) - get_precision() +
+                   other.get_precision()};
+  const auto num_shift{static_cast<std::size_t>(std::max<std::intmax_t>(
+      shift, 0))};
+  const auto den_shift{static_cast<std::size_t>(std::max<std::intmax_t>(
+      -shift, 0))};
+
+  if (bits_in_absolute_value() + num_shift <
+      other.bits_in_absolute_value() + den_shift) {
+    exact = false;
+    return res;
+  }
+
+  auto [q, r] = kernels::div_mod(kernels::shift_left(digits, num_shift),
+                                 kernels::shift_left(other.digits, den_shift));
+  exact = r.empty();
+  res.digits = std::move(q);
+  res.negative = sign() != other.sign();
+  res.remove_leading_zeros();
+  return res;
+}
+
+constexpr ln::Longnum &ln::Longnum::mul_high(const Longnum &other,
+                                             Precision prec) {
+  mul_to_precision(other, prec, false);
+  return *this;
+}
+
+constexpr void ln::Longnum::mul_to_precision(const Longnum &other,
+                                             Precision prec, bool exact) {
+  if (sign() == 0 || other.sign() == 0) {
+    digits = SharedDigits{};
+    negative = false;
+    return;
+  }
+
+  negative = sign() != other.sign();
+  precision += other.precision;
+
+  // Limbs below `start` are skipped. Their sum is less than k * 2^(`start` + 1)
+  // limbs, where k is the length of the shorter operand. Two whole limbs are
+  // kept under the truncated bits so that it can't reach them as long as k
+  // fits into a limb.
+  const auto k{std::min(digits.size(), other.digits.size())};
+  const auto drop_limbs{(static_cast<std::intmax_t>(get_precision()) - prec) /
+                        digit_bits};
+  if (drop_limbs >= 2 &&
+      k <= static_cast<std::size_t>(std::numeric_limits<Digit>::max())) {
+    const auto start{static_cast<std::size_t>(drop_limbs - 2)};
+    auto high{kernels::mul_high(digits, other.digits, start)};
+
+    // Truncated bits of the partial sum, relative to `start`, span two whole
+    // limbs and `rem_bits` more.
+    const auto rem_bits{(get_precision() - prec) % digit_bits};
+    auto limb{[&high](std::size_t i) -> DoubleDigit {
+      return i < high.size() ? high[i] : 0;
+    }};
+    const DoubleDigit mid{limb(1) + k};
+    const DoubleDigit top{(limb(2) & ((DoubleDigit{1} << rem_bits) - 1)) +
+                          (mid >> digit_bits)};
+    const bool safe{top < (DoubleDigit{1} << rem_bits)};
+
+    if (!exact || safe) {
+      digits = std::move(high);
+      precision -= static_cast<Precision>(start * digit_bits);
+      set_precision(prec);
+      remove_leading_zeros();
+      return;
+    }
+  }
+
+  digits = kernels::mul(digits, other.digits);
+  set_precision(prec);
+  remove_leading_zeros();
+}
+
+constexpr ln::Longnum ln::Longnum::operator/(const Longnum &other) const {
+  const auto *ctx{context()};
+  bool exact{};
+  if (ctx != nullptr && ctx->get_rounding() == Rounding::nearest) {
+    auto quotient{truncated_quotient(other, ctx->get_precision() + 1, exact)};
+    quotient.round(ctx->get_precision(), Rounding::nearest);
+    return quotient;
+  }
+
+  auto quotient{truncated_quotient(
+      other,
+      ctx != nullptr ? ctx->get_precision()
+                     : std::max(get_precision(), other.get_precision()),
+      exact)};
+
+  // Same adjustment as in `div_mod`, so that both agree.
+  if (!exact && sign() < 0) {
+    quotient -= other.sign();
+  }
+  return quotient;
+}
+
+constexpr ln::Longnum &ln::Longnum::operator/=(const Longnum &other) {
+  return *this = *this / other;
+}
+
+constexpr ln::Longnum ln::Longnum::operator%(const Longnum &other) const {
+  return div_mod(other).second;
+}
+
+constexpr ln::Longnum &ln::Longnum::operator%=(const Longnum &other) {
+  return *this = div_mod(other).second;
+}
+
+constexpr std::pair<ln::Longnum, ln::Longnum>
+ln::Longnum::div_mod(const Longnum &other) const {
+  WorkingPrecision::Suspend exact_ops{};
+
+  auto this_sign{sign()};
+  auto other_sign{other.sign()};
+
+  if (other_sign == 0) {
+    throw std::invalid_argument("Division by zero is not allowed");
+  }
+
+  if (this_sign == 0) {
+    return {0, 0};
+  }
+
+  bool exact{};
+  const auto prec{std::max(get_precision(), other.get_precision())};
+  auto quotient{truncated_quotient(other, prec, exact)};
+
+  // With a zero quotient, the difference keeps the precision of `*this`.
+  auto rem{*this - quotient * other};
+  if (rem.get_precision() < prec) {
+    rem.set_precision(prec);
+  }
+  if (rem.sign() < 0) {
+    if (other.sign() > 0) {
+      rem += other;
+      quotient -= 1;
+    } else {
+      rem -= other;
+      quotient += 1;
+    }
+  }
+  return {quotient, rem};
+}
+
+constexpr ln::Longnum ln::ldexp(Longnum x, std::int64_t exp) {
+  constexpr std::int64_t min{std::numeric_limits<Longnum::Precision>::min()};
+  constexpr std::int64_t max{std::numeric_limits<Longnum::Precision>::max()};
+
+  // Checked first, so that the difference below can't overflow.
+  if (exp < min || exp > max) {
+    throw std::invalid_argument("Precision is out of range");
+  }
+  const auto prec{static_cast<std::int64_t>(x.precision) - exp};
+  if (prec < min || prec > max) {
+    throw std::invalid_argument("Precision is out of range");
+  }
+
+  x.precision = static_cast<Longnum::Precision>(prec);
+  return x;
+}
+
+constexpr ln::Longnum ln::operator+(Longnum &&a, const Longnum &b) {
+  a += b;
+  return std::move(a);
+}
+
+constexpr ln::Longnum ln::operator+(const Longnum &a, Longnum &&b) {
+  b += a;
+  return std::move(b);
+}
+
+constexpr ln::Longnum ln::operator+(Longnum &&a, Longnum &&b) {
+  if (b.reusable_capacity() > a.reusable_capacity()) {
+    return std::move(b) + a;
+  }
+  return std::move(a) + b;
+}
+
+constexpr ln::Longnum ln::operator-(Longnum &&x) {
+  x.flip_sign();
+  return std::move(x);
+}
+
+constexpr ln::Longnum ln::operator-(Longnum &&a, const Longnum &b) {
+  a -= b;
+  return std::move(a);
+}
+
+constexpr ln::Longnum ln::operator-(const Longnum &a, Longnum &&b) {
+  b -= a;
+  b.flip_sign();
+  return std::move(b);
+}
+
+constexpr ln::Longnum ln::operator-(Longnum &&a, Longnum &&b) {
+  if (b.reusable_capacity() > a.reusable_capacity()) {
+    return a - std::move(b);
+  }
+  return std::move(a) - b;
+}
+
+constexpr ln::Longnum ln::operator*(Longnum &&a, const Longnum &b) {
+  a *= b;
+  return std::move(a);
+}
+
+constexpr ln::Longnum ln::operator*(const Longnum &a, Longnum &&b) {
+  // A zero product keeps the precision of the left operand, so it isn't
+  // written into `b`.
+  if (a.sign() == 0 || b.sign() == 0) {
+    return a * b;
+  }
+  b *= a;
+  return std::move(b);
+}
+
+constexpr ln::Longnum ln::operator*(Longnum &&a, Longnum &&b) {
+  if (b.reusable_capacity() > a.reusable_capacity()) {
+    return a * std::move(b);
+  }
+  return std::move(a) * b;
+}
+
+template <std::integral T>
+constexpr std::strong_ordering ln::Longnum::operator<=>(T other) const {
+  const int other_sign{other < 0 ? -1 : (other > 0 ? 1 : 0)};
+  if (sign() != other_sign) {
+    return sign() <=> other_sign;
+  }
+  if (other_sign == 0) {
+    return std::strong_ordering::equal;
+  }
+
+  const auto abs_other{magnitude(other)};
+  const auto this_msb{static_cast<std::intmax_t>(bits_in_absolute_value()) -
+                      get_precision()};
+  const auto other_msb{static_cast<std::intmax_t>(std::bit_width(abs_other))};
+  auto cmp{this_msb <=> other_msb};
+  if (cmp == 0) {
+    // Both are below 2^`other_msb`, so the integer part fits into
+    // `abs_other`'s type.
+    std::uintmax_t int_part{0};
+    for (std::intmax_t i{0}; i * digit_bits < other_msb; i++) {
+      int_part |= static_cast<std::uintmax_t>(get_digit(i))
+                  << (i * digit_bits);
+    }
+    cmp = int_part <=> abs_other;
+    if (cmp == 0 && countr_zero() < 0) {
+      cmp = std::strong_ordering::greater;
+    }
+  }
+  return negative ? 0 <=> cmp : cmp;
+}
+
+template <std::integral T>
+constexpr bool ln::Longnum::operator==(T other) const {
+  return (*this <=> other) == 0;
+}
+
+template <std::integral T>
+constexpr ln::Longnum &ln::Longnum::operator+=(T other) {
+  if (const auto *ctx{context()}) {
+    WorkingPrecision::Suspend exact{};
+    *this += other;
+    round(ctx->get_precision(), ctx->get_rounding());
+    return *this;
+  }
+
+  if (other == 0) {
+    return *this;
+  }
+
+  // Same as assigning `Longnum(other)`.
+  if (sign() == 0) {
+    precision = 0;
+  }
+  if (get_precision() < 0) {
+    set_precision(0);
+  }
+  add_integral(magnitude(other), other < 0);
+  return *this;
+}
+
+template <std::integral T>
+constexpr ln::Longnum &ln::Longnum::operator-=(T other) {
+  if (const auto *ctx{context()}) {
+    WorkingPrecision::Suspend exact{};
+    *this -= other;
+    round(ctx->get_precision(), ctx->get_rounding());
+    return *this;
+  }
+
+  if (other == 0) {
+    return *this;
+  }
+
+  // Same as assigning `-Longnum(other)`.
+  if (sign() == 0) {
+    precision = 0;
+  }
+  if (get_precision() < 0) {
+    set_precision(0);
+  }
+  add_integral(magnitude(other), other > 0);
+  return *this;
+}
+
+template <std::integral T>
+constexpr ln::Longnum &ln::Longnum::operator*=(T other) {
+  if (const auto *ctx{context()}) {
+    WorkingPrecision::Suspend exact{};
+    *this *= other;
+    round(ctx->get_precision(), ctx->get_rounding());
+    return *this;
+  }
+
+  if (sign() == 0 || other == 0) {
+    digits = SharedDigits{};
+    negative = false;
+    return *this;
+  }
+
+  if (get_precision() < 0) {
+    set_precision(0);
+  }
+  const auto abs_other{magnitude(other)};
+  if (abs_other <= std::numeric_limits<Digit>::max()) {
+    kernels::mul_small(digits.unshared(), static_cast<Digit>(abs_other));
+  } else {
+    digits = kernels::mul(digits, to_digits(abs_other));
+  }
+  negative = negative != (other < 0);
+  remove_leading_zeros();
+  return *this;
+}
+
+template <std::integral T>
+constexpr ln::Longnum &ln::Longnum::operator/=(T other) {
+  if (other == 0) {
+    throw std::invalid_argument("Division by zero is not allowed");
+  }
+
+  // The quotient has the precision it would have with `Longnum(other)`, or
+  // the working one, with one more bit to round to nearest.
+  const auto *ctx{context()};
+  const bool nearest{ctx != nullptr &&
+                     ctx->get_rounding() == Rounding::nearest};
+  const auto prec{ctx == nullptr ? std::max(get_precision(), Precision{0})
+                  : nearest      ? ctx->get_precision() + 1
+                                 : ctx->get_precision()};
+
+  // Truncating the number first doesn't change the truncated quotient, but
+  // makes it inexact.
+  const bool was_negative{sign() < 0};
+  bool exact{sign() == 0 || countr_zero() >= -static_cast<std::intmax_t>(prec)};
+  set_precision(prec);
+  const auto abs_other{magnitude(other)};
+  if (abs_other <= std::numeric_limits<Digit>::max()) {
+    exact = kernels::div_small(digits.unshared(),
+                               static_cast<Digit>(abs_other)) == 0 &&
+            exact;
+  } else {
+    auto [q, r] = kernels::div_mod(digits, to_digits(abs_other));
+    exact = r.empty() && exact;
+    digits = std::move(q);
+  }
+  negative = negative != (other < 0);
+  remove_leading_zeros();
+
+  if (nearest) {
+    round(ctx->get_precision(), Rounding::nearest);
+    return *this;
+  }
+
+  // Same adjustment as in `operator/`.
+  if (!exact && was_negative) {
+    *this -= other < 0 ? -1 : 1;
+  }
+  return *this;
+}
+
+template <std::integral T>
+constexpr ln::Longnum &ln::Longnum::operator%=(T other) {
+  if (other == 0) {
+    throw std::invalid_argument("Division by zero is not allowed");
+  }
+
+  if (sign() == 0) {
+    precision = 0;
+    return *this;
+  }
+
+  // The remainder of `digits` by |`other`| in units of the last place, made
+  // non-negative the same way as in `div_mod`.
+  if (get_precision() < 0) {
+    set_precision(0);
+  }
+  const auto abs_other{magnitude(other)};
+  if (abs_other <= std::numeric_limits<Digit>::max()) {
+    digits = kernels::Digits{
+        kernels::div_small(digits.unshared(), static_cast<Digit>(abs_other))};
+  } else {
+    digits = kernels::div_mod(digits, to_digits(abs_other)).second;
+  }
+  remove_leading_zeros();
+  if (sign() < 0) {
+    add_integral(abs_other, false);
+  }
+  return *this;
+}
+
+template <std::integral T>
+constexpr std::uintmax_t ln::Longnum::magnitude(T value) {
+  using UnsignedT = std::make_unsigned_t<T>;
+  return value < 0 ? static_cast<UnsignedT>(-static_cast<UnsignedT>(value))
+                   : static_cast<UnsignedT>(value);
+}
+
+constexpr ln::kernels::Digits ln::Longnum::to_digits(std::uintmax_t value) {
+  kernels::Digits res{};
+  for (; value != 0; value >>= digit_bits) {
+    res.push_back(static_cast<Digit>(value));
+  }
+  return res;
+}
+
+constexpr void ln::Longnum::add_integral(std::uintmax_t value,
+                                         bool value_negative) {
+  if (value == 0) {
+    return;
+  }
+  if (sign() == 0) {
+    negative = value_negative;
+  }
+
+  // `value` * 2^`precision` takes `value_limbs` limbs from `offset` up.
+  constexpr std::size_t value_bits{std::numeric_limits<std::uintmax_t>::digits};
+  constexpr std::size_t value_limbs{value_bits / digit_bits + 1};
+  const auto offset{static_cast<std::size_t>(precision / digit_bits)};
+  const auto shift{static_cast<std::size_t>(precision % digit_bits)};
+
+  std::array<Digit, value_limbs> shifted{};
+  shifted[0] = static_cast<Digit>(value << shift);
+  for (std::size_t i{1}; i < value_limbs; i++) {
+    const auto src{i * digit_bits - shift};
+    shifted[i] = src < value_bits ? static_cast<Digit>(value >> src) : 0;
+  }
+  auto value_limb{[&](std::size_t i) -> Digit {
+    return i >= offset && i - offset < value_limbs ? shifted[i - offset] : 0;
+  }};
+
+  auto &limbs{digits.unshared()};
+  limbs.resize(std::max(limbs.size(), offset + value_limbs), 0);
+
+  if (negative == value_negative) {
+    Digit carry{0};
+    for (std::size_t i{offset}; i < limbs.size(); i++) {
+      if (i >= offset + value_limbs && carry == 0) {
+        break;
+      }
+      DoubleDigit val{carry};
+      val += limbs[i];
+      val += value_limb(i);
+      limbs[i] = static_cast<Digit>(val);
+      carry = static_cast<Digit>(val >> digit_bits);
+    }
+    if (carry != 0) {
+      limbs.push_back(carry);
+    }
+    remove_leading_zeros();
+    return;
+  }
+
+  // Limbs below `offset` only matter if the rest is equal.
+  auto cmp{std::strong_ordering::equal};
+  for (std::size_t i{limbs.size()}; i-- > offset;) {
+    if (limbs[i] != value_limb(i)) {
+      cmp = limbs[i] <=> value_limb(i);
+      break;
+    }
+  }
+  if (cmp == 0 && std::any_of(limbs.begin(), limbs.begin() + offset,
+                              [](Digit x) { return x != 0; })) {
+    cmp = std::strong_ordering::greater;
+  }
+  if (cmp == 0) {
+    digits = SharedDigits{};
+    negative = false;
+    return;
+  }
+
+  Digit borrow{0};
+  for (std::size_t i{cmp > 0 ? offset : 0}; i < limbs.size(); i++) {
+    if (cmp > 0 && i >= offset + value_limbs && borrow == 0) {
+      break;
+    }
+    DoubleDigit val{cmp > 0 ? limbs[i] : value_limb(i)};
+    val -= cmp > 0 ? value_limb(i) : limbs[i];
+    val -= borrow;
+    limbs[i] = static_cast<Digit>(val);
+    borrow = (val >> digit_bits) ? 1 : 0;
+  }
+  if (cmp < 0) {
+    negative = value_negative;
+  }
+  remove_leading_zeros();
+}
+
+template <std::integral T>
+constexpr ln::Longnum ln::operator+(Longnum a, T b) {
+  a += b;
+  return a;
+}
+
+template <std::integral T>
+constexpr ln::Longnum ln::operator+(T a, Longnum b) {
+  b += a;
+  return b;
+}
+
+template <std::integral T>
+constexpr ln::Longnum ln::operator-(Longnum a, T b) {
+  a -= b;
+  return a;
+}
+
+template <std::integral T>
+constexpr ln::Longnum ln::operator-(T a, Longnum b) {
+  b -= a;
+  b.flip_sign();
+  return b;
+}
+
+template <std::integral T>
+constexpr ln::Longnum ln::operator*(Longnum a, T b) {
+  a *= b;
+  return a;
+}
+
+template <std::integral T>
+constexpr ln::Longnum ln::operator*(T a, Longnum b) {
+  // A zero product keeps the precision of the left operand.
+  if (a == 0 || b.sign() == 0) {
+    return Longnum{};
+  }
+  b *= a;
+  return b;
+}
+
+template <std::integral T>
+constexpr ln::Longnum ln::operator/(Longnum a, T b) {
+  a /= b;
+  return a;
+}
+
+template <std::integral T>
+constexpr ln::Longnum ln::operator/(T a, const Longnum &b) {
+  return Longnum(a) / b;
+}
+
+template <std::integral T>
+constexpr ln::Longnum ln::operator%(Longnum a, T b) {
+  a %= b;
+  return a;
+}
+
+template <std::integral T>
+constexpr ln::Longnum ln::operator%(T a, const Longnum &b) {
+  return Longnum(a) % b;
+}
+
+constexpr ln::Longnum ln::lits::operator""_longnum(unsigned long long other) {
+  return Longnum(other);
+}
+
+constexpr ln::Longnum ln::div(const Longnum &a, const Longnum &b,
+                              Longnum::Precision prec) {
+  bool exact{};
+  return a.truncated_quotient(b, prec, exact);
+}
+
+template <std::size_t N>
+constexpr ln::LongnumLiteral<N>::operator Longnum() const {
+  Longnum res{};
+  res.digits = kernels::Digits(digits.begin(), digits.end());
+  res.precision = precision;
+  res.negative = negative;
+  return res;
+}
+
+template <auto generator> consteval auto ln::bake() {
+  constexpr auto size{generator().digits.size()};
+
+  const Longnum num{generator()};
+  LongnumLiteral<size> res{};
+  std::copy(num.digits.begin(), num.digits.end(), res.digits.begin());
+  res.precision = num.precision;
+  res.negative = num.negative;
+  return res;
+}
+
+constexpr ln::Longnum ln::Longnum::power(std::uint64_t n, Precision prec,
+                                         bool truncate) const {
+  auto mul{[prec, truncate](Longnum &a, const Longnum &b) {
+    a.mul_to_precision(b, truncate ? prec : a.precision + b.precision, true);
+  }};
+  auto square{[&mul](Longnum &a) {
+    const Longnum copy{a};
+    mul(a, copy);
+  }};
+
+  const auto bits{static_cast<std::size_t>(std::bit_width(n))};
+  const auto window{kernels::window_size(bits)};
+
+  // Odd powers x, x^3, ..., x^(2^`window` - 1).
+  std::vector<Longnum> odd_powers{*this};
+  if (window > 1) {
+    Longnum x2{*this};
+    square(x2);
+    for (std::size_t i{1}; i < (std::size_t{1} << (window - 1)); i++) {
+      Longnum next{odd_powers.back()};
+      mul(next, x2);
+      odd_powers.push_back(next);
+    }
+  }
+
+  auto bit{[n](std::size_t i) { return ((n >> i) & 1) != 0; }};
+
+  std::optional<Longnum> res{};
+  for (std::size_t i{bits}; i-- > 0;) {
+    if (!bit(i)) {
+      square(*res);
+      continue;
+    }
+
+    // Take the longest window [j, i] that ends with a set bit.
+    std::size_t j{i + 1 > window ? i + 1 - window : 0};
+    while (!bit(j)) {
+      j++;
+    }
+
+    std::size_t value{0};
+    for (std::size_t k{i + 1}; k-- > j;) {
+      value = (value << 1) | (bit(k) ? 1 : 0);
+      if (res) {
+        square(*res);
+      }
+    }
+    if (res) {
+      mul(*res, odd_powers[value >> 1]);
+    } else {
+      res = odd_powers[value >> 1];
+    }
+    i = j;
+  }
+
+  if (truncate) {
+    res->set_precision(prec);
+  }
+  return *res;
+}
+
+constexpr std::intmax_t ln::Longnum::single_bit() const {
+  if (sign() == 0 || !std::has_single_bit(digits.back())) {
+    return -1;
+  }
+  for (std::size_t i{0}; i + 1 < digits.size(); i++) {
+    if (digits[i] != 0) {
+      return -1;
+    }
+  }
+  return static_cast<std::intmax_t>((digits.size() - 1) * digit_bits +
+                                    std::countr_zero(digits.back()));
+}
+
+constexpr ln::Longnum ln::pow(const Longnum &x, std::uint64_t n) {
+  using Precision = Longnum::Precision;
+
+  if (n == 0) {
+    return Longnum(1);
+  }
+  // Precision may be negative, so it's checked by its magnitude.
+  const std::int64_t x_prec{x.get_precision()};
+  if (static_cast<std::uint64_t>(x_prec < 0 ? -x_prec : x_prec) >
+      std::numeric_limits<Precision>::max() / n) {
+    throw std::invalid_argument("Precision of the power is too big");
+  }
+  const auto prec{
+      static_cast<Precision>(x_prec * static_cast<std::int64_t>(n))};
+
+  if (const auto bit{x.single_bit()}; bit >= 0) {
+    if (bit != 0 && n > std::numeric_limits<std::size_t>::max() /
+                            static_cast<std::uint64_t>(bit)) {
+      throw std::invalid_argument("Exponent of the power is too big");
+    }
+    Longnum res(1);
+    res <<= static_cast<std::size_t>(bit * n);
+    res.precision = prec;
+    res.negative = x.negative && n % 2 == 1;
+    return res;
+  }
+
+  return x.power(n, prec, false);
+}
+
+constexpr ln::Longnum ln::pow(const Longnum &x, std::int64_t n,
+                              Longnum::Precision prec) {
+  if (n < 0 && x.sign() == 0) {
+    throw std::invalid_argument("Division by zero");
+  }
+  const auto abs_n{n < 0 ? static_cast<std::uint64_t>(-(n + 1)) + 1
+                         : static_cast<std::uint64_t>(n)};
+
+  Longnum res(1);
+  if (abs_n == 0) {
+    return res.set_precision(prec);
+  }
+
+  if (const auto bit{x.single_bit()}; bit >= 0) {
+    // |x|^n is 2^`exp`.
+    const auto base_exp{bit - x.get_precision()};
+    if (base_exp != 0 &&
+        abs_n > static_cast<std::uint64_t>(
+                    std::numeric_limits<std::intmax_t>::max() /
+                    (base_exp < 0 ? -base_exp : base_exp))) {
+      throw std::invalid_argument("Exponent of the power is too big");
+    }
+    auto exp{base_exp * static_cast<std::intmax_t>(abs_n)};
+    if (n < 0) {
+      exp = -exp;
+    }
+
+    if (exp + prec < 0) {
+      return Longnum(0, prec);
+    }
+    res <<= static_cast<std::size_t>(exp + prec);
+    res.precision = prec;
+    res.negative = x.negative && abs_n % 2 == 1;
+    return res;
+  }
+
+  if (n >= 0) {
+    return x.power(abs_n, prec, true);
+  }
+
+  // x^n = 2^(`x_prec` * |n|) / m^|n| for the digits m of x, so 1 is divided
+  // once by the exact power of m and nothing is truncated before that.
+  const std::intmax_t x_prec{x.get_precision()};
+  const auto max_prec{std::numeric_limits<Longnum::Precision>::max()};
+  if (x_prec != 0 &&
+      abs_n > static_cast<std::uint64_t>(max_prec / (x_prec < 0 ? -x_prec
+                                                                : x_prec))) {
+    throw std::invalid_argument("Precision of the power is too big");
+  }
+  const auto quotient_prec{prec + x_prec * static_cast<std::intmax_t>(abs_n)};
+  if (quotient_prec > max_prec ||
+      quotient_prec < std::numeric_limits<Longnum::Precision>::min()) {
+    throw std::invalid_argument("Precision of the power is too big");
+  }
+
+  Longnum m{x};
+  m.precision = 0;
+  m.negative = false;
+  res = div(Longnum(1), pow(m, abs_n),
+            static_cast<Longnum::Precision>(quotient_prec));
+  res.precision = prec;
+  res.negative = x.negative && abs_n % 2 == 1 && res.sign() != 0;
+  return res;
+}
+
 #endif
@@ -0,0 +1,92 @@
+#ifndef LONGNUM_ACCUMULATOR_HPP
+#define LONGNUM_ACCUMULATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "longnum.hpp"
+
+namespace ln {
+
+// An exact sum of many numbers, in the spirit of Kulisch's long accumulator.
+// Bits are kept from 2^(-`prec`) up, so terms with no more than `prec` bits
+// for fraction are summed exactly and finer ones are truncated towards zero
+// first, like `set_precision(prec)` does.
+//
+// Limbs are signed 64-bit words holding `digit_bits` bits each, and the
+// spare bits collect carries and borrows of the added terms. So adding a
+// term is a single pass over its limbs with no carry chain, no alignment of
+// the sum and no leading zeros handling. Carries are resolved only once in
+// 2^29 terms and when the value is taken.
+class Accumulator {
+public:
+  using Digit = Longnum::Digit;
+  using DoubleDigit = Longnum::DoubleDigit;
+  using Precision = Longnum::Precision;
+
+  ~Accumulator() = default;
+  Accumulator(const Accumulator &other) = default;
+  Accumulator &operator=(const Accumulator &other) = default;
+  Accumulator(Accumulator &&other) = default;
+  Accumulator &operator=(Accumulator &&other) = default;
+
+  // Initialization with 0 and `prec` bits for fraction.
+  explicit Accumulator(Precision prec);
+
+  // How many bits are used for fraction.
+  Precision get_precision() const;
+
+  // Adds `x`.
+  Accumulator &operator+=(const Longnum &x);
+
+  // Subtracts `x`.
+  Accumulator &operator-=(const Longnum &x);
+
+  // Adds `a` * `b`. The product is not rounded before it's added.
+  Accumulator &add_product(const Longnum &a, const Longnum &b);
+
+  // The sum so far, with `get_precision()` bits for fraction.
+  Longnum value() const;
+
+  // Resets the sum to 0.
+  void clear();
+
+#ifndef LONGNUM_TEST_PRIVATE
+private:
+#endif
+  Precision precision{};
+
+  // `i`'th limb weighs 2^(`i` * `digit_bits` - `precision`). Limbs are in
+  // [0, 2^`digit_bits`) right after `normalize` except for the top one,
+  // which is negative if the sum is.
+  std::vector<std::int64_t> limbs{};
+
+  // Terms that can be added before the limbs may overflow.
+  std::uint64_t adds_left{};
+
+  // Adds or subtracts `digits` * 2^(`sh` - `precision`).
+  void add_shifted(const kernels::Digits &digits, std::size_t sh,
+                   bool negative);
+
+  // Adds `digits` * 2^(-`prec`) with the given sign.
+  void add_scaled(const kernels::Digits &digits, std::intmax_t prec,
+                  bool negative);
+
+  // Moves carries up, so that every limb but the top one is a plain digit.
+  void normalize();
+};
+
+// Sum of all `values`, computed exactly with an `Accumulator`. The result
+// has the max precision of the values.
+Longnum sum(std::span<const Longnum> values);
+
+// Dot product of `a` and `b`, computed exactly with an `Accumulator`. The
+// result has the max precision of the products. Throws if the sizes differ.
+Longnum dot(std::span<const Longnum> a, std::span<const Longnum> b);
+
+} // namespace ln
+
+#endif
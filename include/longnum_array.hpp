@@ -0,0 +1,98 @@
+#ifndef LONGNUM_ARRAY_HPP
+#define LONGNUM_ARRAY_HPP
+
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "longnum.hpp"
+
+namespace ln {
+
+// A fixed-size array of fixed-point numbers that all share the same layout:
+// `int_limbs` limbs for the integer part and `frac_limbs` limbs for the
+// fraction. Limbs are kept in a single buffer in structure-of-arrays form, so
+// that element-wise kernels process many numbers per instruction.
+//
+// Every element is stored in two's complement in `width()` limbs. Arithmetic
+// wraps around on overflow, like with built-in integers, and the fraction is
+// truncated towards zero, like `Longnum` does.
+class LongnumArray {
+public:
+  using Digit = Longnum::Digit;
+  using DoubleDigit = Longnum::DoubleDigit;
+  using Precision = Longnum::Precision;
+
+  ~LongnumArray() = default;
+  LongnumArray(const LongnumArray &other) = default;
+  LongnumArray &operator=(const LongnumArray &other) = default;
+  LongnumArray(LongnumArray &&other) = default;
+  LongnumArray &operator=(LongnumArray &&other) = default;
+
+  // Initialization with `size` zeros. `int_limbs + frac_limbs` must not be 0.
+  LongnumArray(std::size_t size, std::size_t int_limbs, std::size_t frac_limbs);
+
+  // Initialization with a copy of `values` converted to the given layout.
+  LongnumArray(std::span<const Longnum> values, std::size_t int_limbs,
+               std::size_t frac_limbs);
+
+  // Number of elements.
+  std::size_t size() const;
+
+  // Limbs per element.
+  std::size_t width() const;
+
+  // How many bits are used for fraction, same for every element.
+  Precision get_precision() const;
+
+  // Converts `i`'th element to a `Longnum`.
+  Longnum get(std::size_t i) const;
+
+  // Stores `value` as `i`'th element. Extra fraction bits are truncated and
+  // extra integer bits are wrapped around.
+  void set(std::size_t i, const Longnum &value);
+
+  // Converts all the elements to `Longnum`s.
+  std::vector<Longnum> to_vector() const;
+
+  // Element-wise addition. Throws if layouts or sizes differ.
+  LongnumArray operator+(const LongnumArray &other) const;
+
+  // Element-wise addition. Throws if layouts or sizes differ.
+  LongnumArray &operator+=(const LongnumArray &other);
+
+  // Element-wise subtraction. Throws if layouts or sizes differ.
+  LongnumArray operator-(const LongnumArray &other) const;
+
+  // Element-wise subtraction. Throws if layouts or sizes differ.
+  LongnumArray &operator-=(const LongnumArray &other);
+
+  // Element-wise multiplication. Throws if layouts or sizes differ.
+  LongnumArray operator*(const LongnumArray &other) const;
+
+  // Element-wise multiplication. Throws if layouts or sizes differ.
+  LongnumArray &operator*=(const LongnumArray &other);
+
+  // Element-wise comparison. `i`'th value of the result is negative, zero or
+  // positive, if `i`'th element of `*this` is less than, equal to or greater
+  // than the one of `other`. Throws if layouts or sizes differ.
+  std::vector<int> compare(const LongnumArray &other) const;
+
+#ifndef LONGNUM_TEST_PRIVATE
+private:
+#endif
+  std::size_t count{};
+  std::size_t int_limbs{};
+  std::size_t frac_limbs{};
+
+  // `k`'th limb of `i`'th element is stored at `limbs[k * count + i]`.
+  std::vector<Digit> limbs{};
+
+  // Throws if `other` can't be used together with `*this`.
+  void check_layout(const LongnumArray &other) const;
+};
+
+} // namespace ln
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef LONGNUM_ASYNC_HPP
+#define LONGNUM_ASYNC_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "longnum.hpp"
+
+namespace ln {
+
+// Runs tasks somewhere. Implement it to plug operations into an existing
+// thread pool or event loop.
+class Executor {
+public:
+  virtual ~Executor() = default;
+
+  // Schedules `task` to run. Must not run it on the calling thread before
+  // returning.
+  virtual void submit(std::function<void()> task) = 0;
+};
+
+// A fixed number of threads taking tasks from a shared queue. Tasks still in
+// the queue when the pool is destroyed are dropped.
+class ThreadPool final : public Executor {
+public:
+  ~ThreadPool() override;
+  ThreadPool(const ThreadPool &other) = delete;
+  ThreadPool &operator=(const ThreadPool &other) = delete;
+  ThreadPool(ThreadPool &&other) = delete;
+  ThreadPool &operator=(ThreadPool &&other) = delete;
+
+  // Initialization with `threads` worker threads. Throws if it's 0.
+  explicit ThreadPool(std::size_t threads);
+
+  void submit(std::function<void()> task) override;
+
+#ifndef LONGNUM_TEST_PRIVATE
+private:
+#endif
+  std::mutex mutex{};
+  std::condition_variable_any cv{};
+  std::deque<std::function<void()>> tasks{};
+  std::vector<std::jthread> workers{};
+};
+
+// Thrown by the futures of operations that were cancelled.
+class Cancelled : public std::runtime_error {
+public:
+  Cancelled() : std::runtime_error("Operation was cancelled") {}
+};
+
+// Runs expensive operations on an executor and returns futures for the
+// results. Every operation takes a stop token, which is checked each time a
+// block of limbs is processed, and a progress callback, which is called from
+// the executor with an estimate of the completed fraction, from 0 to 1, each
+// time it grows by at least 1%.
+//
+// Results are exactly the same as of the usual synchronous operations.
+class AsyncContext {
+public:
+  using Progress = std::function<void(double fraction)>;
+
+  ~AsyncContext() = default;
+  AsyncContext(const AsyncContext &other) = default;
+  AsyncContext &operator=(const AsyncContext &other) = default;
+  AsyncContext(AsyncContext &&other) = default;
+  AsyncContext &operator=(AsyncContext &&other) = default;
+
+  // Initialization with an executor, which must outlive the context and all
+  // the operations started by it.
+  explicit AsyncContext(Executor &executor);
+
+  // Same as `a * b`.
+  std::future<Longnum> multiply(Longnum a, Longnum b, std::stop_token stop = {},
+                                Progress progress = {}) const;
+
+  // Same as `a.div_mod(b)`.
+  std::future<std::pair<Longnum, Longnum>>
+  div_mod(Longnum a, Longnum b, std::stop_token stop = {},
+          Progress progress = {}) const;
+
+  // Same as `x.to_string(fp_digits)`.
+  std::future<std::string> to_string(Longnum x, std::uint32_t fp_digits,
+                                     std::stop_token stop = {},
+                                     Progress progress = {}) const;
+
+  // Same as `Longnum::from_string(str, prec)`.
+  std::future<Longnum> parse(std::string str, Longnum::Precision prec,
+                             std::stop_token stop = {},
+                             Progress progress = {}) const;
+
+#ifndef LONGNUM_TEST_PRIVATE
+private:
+#endif
+  Executor *executor{};
+
+  // Runs `op` on the executor, with `total_work` limb operations expected.
+  template <class T>
+  std::future<T> run(std::function<T()> op, double total_work,
+                     std::stop_token stop, Progress progress) const;
+};
+
+} // namespace ln
+
+#endif
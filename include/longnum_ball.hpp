@@ -0,0 +1,107 @@
+#ifndef LONGNUM_BALL_HPP
+#define LONGNUM_BALL_HPP
+
+#include <cstdint>
+
+#include "longnum.hpp"
+
+namespace ln {
+
+// A ball [mid - rad, mid + rad] that is guaranteed to contain the exact
+// value of a computation. The midpoint is a `Longnum` and goes through the
+// usual fixed-point arithmetic, the radius is a double-precision mantissa
+// with a separate exponent, so keeping track of errors costs a few
+// floating-point operations per arithmetic operation.
+//
+// Radius operations are rounded upwards, and errors of truncating the
+// midpoint are added to the radius, so the bounds are rigorous.
+class Ball {
+public:
+  using Precision = Longnum::Precision;
+
+  ~Ball() = default;
+  Ball(const Ball &other) = default;
+  Ball &operator=(const Ball &other) = default;
+  Ball(Ball &&other) = default;
+  Ball &operator=(Ball &&other) = default;
+
+  // Zero.
+  Ball() = default;
+
+  // An exact value.
+  Ball(const Longnum &mid);
+
+  // A value known up to `rad`, which is taken by absolute value.
+  Ball(const Longnum &mid, const Longnum &rad);
+
+  // The midpoint.
+  const Longnum &mid() const;
+
+  // The radius, exactly.
+  Longnum rad() const;
+
+  // Lower and upper ends of the ball.
+  Longnum lower() const;
+  Longnum upper() const;
+
+  // Returns the greatest `p` such that the radius is at most 2^(-`p`), that
+  // is how many bits of fraction are certified. Returns the max value of
+  // `Precision` for exact values.
+  Precision certified_precision() const;
+
+  // Returns whether `x` is inside the ball.
+  bool contains(const Longnum &x) const;
+
+  Ball operator-() const;
+
+  Ball operator+(const Ball &other) const;
+  Ball &operator+=(const Ball &other);
+
+  Ball operator-(const Ball &other) const;
+  Ball &operator-=(const Ball &other);
+
+  // The midpoint is multiplied the same way `Longnum` does it.
+  Ball operator*(const Ball &other) const;
+  Ball &operator*=(const Ball &other);
+
+  // The midpoint is divided with `div` to the max precision of the operands.
+  // Throws if `other` contains zero.
+  Ball operator/(const Ball &other) const;
+  Ball &operator/=(const Ball &other);
+
+#ifndef LONGNUM_TEST_PRIVATE
+private:
+#endif
+  // Non-negative number `mant` * 2^`exp`, where `mant` is 0 or in [0.5, 1).
+  struct Bound {
+    double mant{};
+    std::int64_t exp{};
+
+    // Bounds of |`x`| from above and from below.
+    static Bound above(const Longnum &x);
+    static Bound below(const Longnum &x);
+
+    // 2^`exp`.
+    static Bound power_of_two(std::int64_t exp);
+
+    // Brings `mant` back into [0.5, 1).
+    Bound &normalize();
+
+    // Exact value.
+    Longnum to_longnum() const;
+
+    // Results are rounded upwards, except for `sub_down` that is rounded
+    // downwards and clamped at 0.
+    static Bound add(const Bound &a, const Bound &b);
+    static Bound mul(const Bound &a, const Bound &b);
+    static Bound div(const Bound &a, const Bound &b);
+    static Bound sub_down(const Bound &a, const Bound &b);
+  };
+
+  Longnum midpoint{};
+  Bound radius{};
+};
+
+} // namespace ln
+
+#endif
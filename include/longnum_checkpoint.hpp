@@ -0,0 +1,108 @@
+#ifndef LONGNUM_CHECKPOINT_HPP
+#define LONGNUM_CHECKPOINT_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "longnum.hpp"
+
+namespace ln {
+
+// Periodic snapshots of a long computation, so that it can be resumed after
+// the process dies. A snapshot is a step counter and a fixed list of numbers
+// (the loop state), and is kept in a directory:
+//
+// - every number is stored with `Longnum::write_binary` in one of two files
+//   of its slot, which take turns. A number that is exactly the same as in
+//   the previous snapshot keeps its file. Otherwise it goes into the other
+//   file, which holds an older snapshot of the slot, and only the blocks of
+//   `block_size` bytes that differ from what the file has are written. Low
+//   limbs of a growing power and high limbs of a converging sum stay put, so
+//   a loop like the one computing pi writes a fraction of its state;
+// - a manifest lists the files of the latest complete snapshot. It is
+//   replaced by a rename only after all the files are written and flushed to
+//   disk, so a crash in the middle of a write, or of the system, leaves the
+//   previous snapshot intact.
+//
+// The two files of a slot take up to twice the disk space of the state.
+// Writing happens on a background thread. `save` only copies the numbers and
+// returns, and if the previous snapshot is still being written, the one
+// waiting in the queue is replaced by the newer one.
+class Checkpointer {
+public:
+  struct Snapshot {
+    std::uint64_t step{};
+    std::vector<Longnum> state{};
+  };
+
+  // Size of the blocks that a changed number is compared and written in.
+  static constexpr std::size_t block_size{1 << 16};
+
+  // Waits for the pending snapshot to be written. Errors are ignored, call
+  // `wait` first to get them.
+  ~Checkpointer();
+  Checkpointer(const Checkpointer &other) = delete;
+  Checkpointer &operator=(const Checkpointer &other) = delete;
+  Checkpointer(Checkpointer &&other) = delete;
+  Checkpointer &operator=(Checkpointer &&other) = delete;
+
+  // Initialization with the directory for snapshots, it is created if
+  // missing.
+  explicit Checkpointer(std::filesystem::path dir);
+
+  // Reads the latest complete snapshot, if there is one. Throws if the
+  // snapshot is damaged.
+  std::optional<Snapshot> load() const;
+
+  // Schedules a snapshot of `state` at `step`. Rethrows an error of a
+  // previous write, if there was one.
+  void save(std::uint64_t step, std::span<const Longnum> state);
+
+  // Blocks until all the scheduled snapshots are written. Rethrows an error
+  // of a write, if there was one.
+  void wait();
+
+#ifndef LONGNUM_TEST_PRIVATE
+private:
+#endif
+  std::filesystem::path dir{};
+
+  std::mutex mutex{};
+  std::condition_variable cv{};
+  std::optional<Snapshot> pending{};
+  bool busy{};
+  bool stopping{};
+  std::exception_ptr error{};
+
+  // The last written snapshot and its files, only used by the writer thread.
+  Snapshot written{};
+  std::vector<std::string> written_files{};
+  std::uint64_t generation{};
+  // Blocks that had to be written so far.
+  std::uint64_t written_blocks{};
+
+  std::thread writer{};
+
+  // Body of the writer thread.
+  void run();
+
+  // Writes `snapshot` and makes it the latest one.
+  void write(Snapshot snapshot);
+
+  // Throws and forgets an error of the writer thread, if there was one. Must
+  // be called with `mutex` held.
+  void rethrow_error();
+};
+
+} // namespace ln
+
+#endif
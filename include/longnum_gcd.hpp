@@ -0,0 +1,32 @@
+#ifndef LONGNUM_GCD_HPP
+#define LONGNUM_GCD_HPP
+
+#include "longnum.hpp"
+
+namespace ln {
+
+// Result of `xgcd`: `a` * `s` + `b` * `t` = `gcd`.
+struct XgcdResult {
+  Longnum gcd{};
+  Longnum s{};
+  Longnum t{};
+};
+
+// All the functions below treat numbers as integers: fraction bits are
+// dropped the same way `set_precision(0)` does. Results have precision of 0.
+
+// Greatest common divisor, always non-negative. gcd(0, 0) is 0. Uses
+// Lehmer's algorithm, so most steps work on single limbs instead of whole
+// numbers.
+Longnum gcd(const Longnum &a, const Longnum &b);
+
+// Extended Euclidean algorithm, same as `gcd` but also finds Bezout
+// coefficients.
+XgcdResult xgcd(const Longnum &a, const Longnum &b);
+
+// Least common multiple, always non-negative. lcm(x, 0) is 0.
+Longnum lcm(const Longnum &a, const Longnum &b);
+
+} // namespace ln
+
+#endif
@@ -0,0 +1,521 @@
+#ifndef LONGNUM_KERNELS_HPP
+#define LONGNUM_KERNELS_HPP
+
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Low-level routines working on raw limb vectors. A limb vector is a
+// little-endian sequence of digits in radix 2^`digit_bits` representing a
+// non-negative integer. Unless stated otherwise, inputs must have no leading
+// zeros and outputs have none either (zero is an empty vector).
+namespace ln::kernels {
+
+#if defined(__x86_64__) || defined(_WIN64)
+using Digit = std::uint32_t;
+using DoubleDigit = std::uint64_t;
+#elif defined(__i386__) || defined(_WIN32)
+using Digit = std::uint16_t;
+using DoubleDigit = std::uint32_t;
+#else
+#error "The system is not 64-bit niether 32-bit and therefore not supported"
+#endif
+
+using Digits = std::vector<Digit>;
+
+inline constexpr auto digit_bits{std::numeric_limits<Digit>::digits};
+
+// Routines that take long report the work they've done, in limb operations,
+// to the monitor of the current thread, if there is one. A monitor may throw
+// to abort the computation, no routine leaves anything half-done behind.
+class WorkMonitor {
+public:
+  virtual void report(std::size_t work) = 0;
+
+protected:
+  ~WorkMonitor() = default;
+};
+
+inline thread_local WorkMonitor *work_monitor{nullptr};
+
+// Work is reported in blocks of at least that many limb operations, so that
+// the cost of reporting is negligible.
+inline constexpr std::size_t work_block{std::size_t{1} << 16};
+
+// Adds `work` to `pending` and reports it once a block is collected. Nothing
+// is reported during constant evaluation.
+constexpr void report_work(std::size_t &pending, std::size_t work) {
+  pending += work;
+  if (pending < work_block) {
+    return;
+  }
+  if (!std::is_constant_evaluated() && work_monitor != nullptr) {
+    work_monitor->report(pending);
+  }
+  pending = 0;
+}
+
+// Removes leading zeros.
+constexpr void trim(Digits &a) {
+  while (!a.empty() && a.back() == 0) {
+    a.pop_back();
+  }
+}
+
+// Compares two limb vectors.
+constexpr std::strong_ordering compare(const Digits &a, const Digits &b) {
+  if (a.size() != b.size()) {
+    return a.size() <=> b.size();
+  }
+  for (std::size_t i{a.size()}; i-- > 0;) {
+    if (a[i] != b[i]) {
+      return a[i] <=> b[i];
+    }
+  }
+  return std::strong_ordering::equal;
+}
+
+// Returns `a` + `b`.
+constexpr Digits add(const Digits &a, const Digits &b) {
+  const auto &longer{a.size() >= b.size() ? a : b};
+  const auto &shorter{a.size() >= b.size() ? b : a};
+
+  Digits res(longer.size() + 1, 0);
+  Digit carry{0};
+  for (std::size_t i{0}; i < longer.size(); i++) {
+    DoubleDigit val{carry};
+    val += longer[i];
+    val += i < shorter.size() ? shorter[i] : Digit{0};
+    res[i] = static_cast<Digit>(val);
+    carry = static_cast<Digit>(val >> digit_bits);
+  }
+  res[longer.size()] = carry;
+
+  trim(res);
+  return res;
+}
+
+// Returns `a` - `b`. `a` must not be less than `b`.
+constexpr Digits sub(const Digits &a, const Digits &b) {
+  Digits res(a.size(), 0);
+  Digit borrow{0};
+  for (std::size_t i{0}; i < a.size(); i++) {
+    DoubleDigit val{a[i]};
+    val -= i < b.size() ? b[i] : Digit{0};
+    val -= borrow;
+    res[i] = static_cast<Digit>(val);
+    borrow = (val >> digit_bits) ? 1 : 0;
+  }
+
+  trim(res);
+  return res;
+}
+
+// Returns `a` multiplied by 2^`sh`.
+constexpr Digits shift_left(const Digits &a, std::size_t sh) {
+  if (a.empty()) {
+    return {};
+  }
+
+  const auto limbs{sh / digit_bits};
+  const auto bits{sh % digit_bits};
+
+  Digits res(a.size() + limbs + 1, 0);
+  for (std::size_t i{0}; i < a.size(); i++) {
+    res[i + limbs] |= static_cast<Digit>(a[i] << bits);
+    if (bits != 0) {
+      res[i + limbs + 1] = static_cast<Digit>(a[i] >> (digit_bits - bits));
+    }
+  }
+
+  trim(res);
+  return res;
+}
+
+// Returns `a` divided by 2^`sh`, rounded down.
+constexpr Digits shift_right(const Digits &a, std::size_t sh) {
+  const auto limbs{sh / digit_bits};
+  const auto bits{sh % digit_bits};
+  if (limbs >= a.size()) {
+    return {};
+  }
+
+  Digits res(a.size() - limbs, 0);
+  for (std::size_t i{0}; i < res.size(); i++) {
+    res[i] = static_cast<Digit>(a[i + limbs] >> bits);
+    if (bits != 0 && i + limbs + 1 < a.size()) {
+      res[i] |= static_cast<Digit>(a[i + limbs + 1] << (digit_bits - bits));
+    }
+  }
+
+  trim(res);
+  return res;
+}
+
+// Multiplies `a` by `m` and adds `add` in place.
+constexpr void mul_small(Digits &a, Digit m, Digit add = 0) {
+  DoubleDigit carry{add};
+  for (auto &x : a) {
+    DoubleDigit val{static_cast<DoubleDigit>(x) * m + carry};
+    x = static_cast<Digit>(val);
+    carry = val >> digit_bits;
+  }
+  if (carry != 0) {
+    a.push_back(static_cast<Digit>(carry));
+  }
+  trim(a);
+}
+
+// Divides `a` by `d` in place and returns the remainder. `d` must not be 0.
+constexpr Digit div_small(Digits &a, Digit d) {
+  DoubleDigit rem{0};
+  for (std::size_t i{a.size()}; i-- > 0;) {
+    DoubleDigit cur{(rem << digit_bits) | a[i]};
+    a[i] = static_cast<Digit>(cur / d);
+    rem = cur % d;
+  }
+  trim(a);
+  return static_cast<Digit>(rem);
+}
+
+// Operand limbs multiplied against all rows of the other operand at once in
+// `mul`. A block and its window of the result stay in L1 cache.
+inline constexpr std::size_t mul_block{1024};
+
+// Smaller products in `mul` go one row at a time, tiling doesn't pay off for
+// them.
+inline constexpr std::size_t mul_tiled_min{32};
+
+// Adds `carry` to the limbs from `res` up. The result must fit.
+constexpr void add_carry(Digit *res, DoubleDigit carry) {
+  for (; carry != 0; res++) {
+    carry += *res;
+    *res = static_cast<Digit>(carry);
+    carry >>= digit_bits;
+  }
+}
+
+// Adds `m` * b[0..`n`) to the limbs from `res` up.
+constexpr void mul_row(Digit *res, Digit m, const Digit *b, std::size_t n) {
+  DoubleDigit carry{0};
+  for (std::size_t j{0}; j < n; j++) {
+    DoubleDigit val{carry + static_cast<DoubleDigit>(m) * b[j]};
+    val += res[j];
+    res[j] = static_cast<Digit>(val);
+    carry = val >> digit_bits;
+  }
+  add_carry(res + n, carry);
+}
+
+// Adds a[0..4) * b[0..`n`) to the limbs from `res` up, where `b` is padded
+// with 3 zero limbs at both ends. Each limb of `res` is loaded and stored
+// once for all four rows, which pass it on to each other with a carry of
+// their own. A step adds two limbs to a product of two, so it never
+// overflows a `DoubleDigit`.
+constexpr void mul_rows4(Digit *res, const Digit *a, const Digit *padded_b,
+                         std::size_t n) {
+  const DoubleDigit a0{a[0]};
+  const DoubleDigit a1{a[1]};
+  const DoubleDigit a2{a[2]};
+  const DoubleDigit a3{a[3]};
+  DoubleDigit c0{0};
+  DoubleDigit c1{0};
+  DoubleDigit c2{0};
+  DoubleDigit c3{0};
+
+  // Row r multiplies b[j - r] at column j, the padding is there for the
+  // first and last columns, where some rows only pass their carries on.
+  for (std::size_t j{0}; j < n + 3; j++) {
+    const Digit *b{padded_b + j};
+    DoubleDigit val{a0 * b[3] + c0 + res[j]};
+    c0 = val >> digit_bits;
+    val = a1 * b[2] + c1 + static_cast<Digit>(val);
+    c1 = val >> digit_bits;
+    val = a2 * b[1] + c2 + static_cast<Digit>(val);
+    c2 = val >> digit_bits;
+    val = a3 * b[0] + c3 + static_cast<Digit>(val);
+    c3 = val >> digit_bits;
+    res[j] = static_cast<Digit>(val);
+  }
+  add_carry(res + n + 3, c0 + c1 + c2 + c3);
+}
+
+// Schoolbook multiplication. Rows of `a` go four at a time, against blocks of
+// `mul_block` limbs of `b` padded as `mul_rows4` needs.
+constexpr Digits mul(const Digits &a, const Digits &b) {
+  if (a.empty() || b.empty()) {
+    return {};
+  }
+
+  Digits res(a.size() + b.size(), 0);
+  Digits padded{};
+  const bool tiled{std::min(a.size(), b.size()) >= mul_tiled_min};
+
+  std::size_t work{0};
+  for (std::size_t first{0}; first < b.size(); first += mul_block) {
+    const auto n{std::min(mul_block, b.size() - first)};
+    if (tiled) {
+      padded.assign(3, 0);
+      padded.insert(padded.end(), b.begin() + first, b.begin() + first + n);
+      padded.insert(padded.end(), 3, 0);
+    }
+
+    std::size_t i{0};
+    for (; tiled && i + 4 <= a.size(); i += 4) {
+      if (a[i] == 0 && a[i + 1] == 0 && a[i + 2] == 0 && a[i + 3] == 0) {
+        continue;
+      }
+      report_work(work, 4 * n);
+      mul_rows4(res.data() + i + first, a.data() + i, padded.data(), n);
+    }
+    for (; i < a.size(); i++) {
+      if (a[i] == 0) {
+        continue;
+      }
+      report_work(work, n);
+      mul_row(res.data() + i + first, a[i], b.data() + first, n);
+    }
+  }
+
+  trim(res);
+  return res;
+}
+
+// Short product: sums only the partial products a[i] * b[j] with
+// i + j >= `start` and returns that sum divided by 2^(`start` * `digit_bits`).
+// The skipped partial products add up to less than
+// min(a.size(), b.size()) * 2^((`start` + 1) * `digit_bits`), so the result
+// is at most that much (shifted down) below the exact high part of a * b.
+constexpr Digits mul_high(const Digits &a, const Digits &b, std::size_t start) {
+  if (a.empty() || b.empty() || start >= a.size() + b.size()) {
+    return {};
+  }
+
+  Digits res(a.size() + b.size() - start, 0);
+
+  std::size_t work{0};
+  for (std::size_t i{0}; i < a.size(); i++) {
+    if (a[i] == 0 || i + b.size() <= start) {
+      continue;
+    }
+
+    DoubleDigit carry{0};
+    const std::size_t first{start > i ? start - i : 0};
+    report_work(work, b.size() - first);
+    for (std::size_t j{first}; j < b.size(); j++) {
+      DoubleDigit val{carry + static_cast<DoubleDigit>(a[i]) *
+                                  static_cast<DoubleDigit>(b[j])};
+      val += res[i + j - start];
+      res[i + j - start] = static_cast<Digit>(val);
+      carry = val >> digit_bits;
+    }
+
+    if (carry != 0) {
+      res[i + b.size() - start] = static_cast<Digit>(carry);
+    }
+  }
+
+  trim(res);
+  return res;
+}
+
+// Returns quotient (first) and remainder (second) of `u` divided by `v`.
+// `v` must not be 0. Uses Knuth's algorithm D.
+constexpr std::pair<Digits, Digits> div_mod(const Digits &u, const Digits &v) {
+  if (compare(u, v) < 0) {
+    return {{}, u};
+  }
+
+  if (v.size() == 1) {
+    Digits q{u};
+    Digits r{};
+    if (auto rem{div_small(q, v[0])}; rem != 0) {
+      r.push_back(rem);
+    }
+    return {q, r};
+  }
+
+  constexpr DoubleDigit base{static_cast<DoubleDigit>(1) << digit_bits};
+
+  const auto n{v.size()};
+  const auto m{u.size() - n};
+  const auto s{std::countl_zero(v.back())};
+
+  // Normalize so that the top limb of the divisor has its high bit set.
+  Digits vn(n, 0);
+  Digits un(u.size() + 1, 0);
+  for (std::size_t i{n}; i-- > 0;) {
+    vn[i] = static_cast<Digit>(v[i] << s);
+    if (s != 0 && i > 0) {
+      vn[i] |= static_cast<Digit>(v[i - 1] >> (digit_bits - s));
+    }
+  }
+  for (std::size_t i{u.size()}; i-- > 0;) {
+    un[i] = static_cast<Digit>(u[i] << s);
+    if (s != 0 && i > 0) {
+      un[i] |= static_cast<Digit>(u[i - 1] >> (digit_bits - s));
+    }
+  }
+  if (s != 0) {
+    un[u.size()] = static_cast<Digit>(u.back() >> (digit_bits - s));
+  }
+
+  Digits q(m + 1, 0);
+  std::size_t work{0};
+  for (std::size_t j{m + 1}; j-- > 0;) {
+    report_work(work, n);
+    DoubleDigit num{(static_cast<DoubleDigit>(un[j + n]) << digit_bits) |
+                    un[j + n - 1]};
+    DoubleDigit qhat{num / vn[n - 1]};
+    DoubleDigit rhat{num % vn[n - 1]};
+    while (qhat >= base ||
+           qhat * vn[n - 2] > ((rhat << digit_bits) | un[j + n - 2])) {
+      qhat--;
+      rhat += vn[n - 1];
+      if (rhat >= base) {
+        break;
+      }
+    }
+
+    DoubleDigit carry{0};
+    Digit borrow{0};
+    for (std::size_t i{0}; i < n; i++) {
+      DoubleDigit p{qhat * vn[i] + carry};
+      carry = p >> digit_bits;
+      DoubleDigit val{un[i + j]};
+      val -= static_cast<Digit>(p);
+      val -= borrow;
+      un[i + j] = static_cast<Digit>(val);
+      borrow = (val >> digit_bits) ? 1 : 0;
+    }
+    DoubleDigit val{un[j + n]};
+    val -= carry;
+    val -= borrow;
+    un[j + n] = static_cast<Digit>(val);
+
+    if (val >> digit_bits) {
+      // Estimated digit was one too big, add the divisor back.
+      qhat--;
+      DoubleDigit c{0};
+      for (std::size_t i{0}; i < n; i++) {
+        DoubleDigit sum{static_cast<DoubleDigit>(un[i + j]) + vn[i] + c};
+        un[i + j] = static_cast<Digit>(sum);
+        c = sum >> digit_bits;
+      }
+      un[j + n] = static_cast<Digit>(un[j + n] + c);
+    }
+
+    q[j] = static_cast<Digit>(qhat);
+  }
+
+  Digits r(n, 0);
+  for (std::size_t i{0}; i < n; i++) {
+    r[i] = static_cast<Digit>(un[i] >> s);
+    if (s != 0) {
+      r[i] |= static_cast<Digit>(un[i + 1] << (digit_bits - s));
+    }
+  }
+
+  trim(q);
+  trim(r);
+  return {q, r};
+}
+
+// Window size for sliding window exponentiation with a `bits` long exponent.
+// The thresholds are where the precomputed odd powers start to pay off.
+constexpr std::size_t window_size(std::size_t bits) {
+  if (bits > 671) {
+    return 6;
+  }
+  if (bits > 239) {
+    return 5;
+  }
+  if (bits > 79) {
+    return 4;
+  }
+  if (bits > 23) {
+    return 3;
+  }
+  return bits > 1 ? 2 : 1;
+}
+
+// Returns -`m0`^(-1) modulo 2^`digit_bits`. `m0` must be odd.
+constexpr Digit mont_inverse(Digit m0) {
+  // Newton's iteration, every step doubles the number of correct low bits.
+  // Odd numbers are their own inverses modulo 8, so 3 bits are correct at
+  // start.
+  Digit inv{m0};
+  for (int bits{3}; bits < digit_bits; bits *= 2) {
+    const auto err{static_cast<Digit>(2 - static_cast<DoubleDigit>(m0) * inv)};
+    inv = static_cast<Digit>(static_cast<DoubleDigit>(inv) * err);
+  }
+  return static_cast<Digit>(0 - inv);
+}
+
+// Montgomery multiplication: returns `a` * `b` * 2^(-n * `digit_bits`)
+// modulo `m`, where n is `m.size()`. `a` and `b` must be less than `m` and
+// `m` must be odd. `m_inv` is `mont_inverse(m[0])`. Operands and the result
+// are exactly n limbs long, leading zeros included.
+constexpr Digits mont_mul(const Digits &a, const Digits &b, const Digits &m,
+                          Digit m_inv) {
+  const auto n{m.size()};
+  Digits t(n + 2, 0);
+
+  for (std::size_t i{0}; i < n; i++) {
+    DoubleDigit carry{0};
+    for (std::size_t j{0}; j < n; j++) {
+      DoubleDigit val{static_cast<DoubleDigit>(a[j]) * b[i] + t[j] + carry};
+      t[j] = static_cast<Digit>(val);
+      carry = val >> digit_bits;
+    }
+    DoubleDigit val{static_cast<DoubleDigit>(t[n]) + carry};
+    t[n] = static_cast<Digit>(val);
+    t[n + 1] = static_cast<Digit>(val >> digit_bits);
+
+    // Add a multiple of `m` that makes the lowest limb 0 and drop it.
+    const Digit q{static_cast<Digit>(static_cast<DoubleDigit>(t[0]) * m_inv)};
+    carry = (static_cast<DoubleDigit>(q) * m[0] + t[0]) >> digit_bits;
+    for (std::size_t j{1}; j < n; j++) {
+      DoubleDigit cur{static_cast<DoubleDigit>(q) * m[j] + t[j] + carry};
+      t[j - 1] = static_cast<Digit>(cur);
+      carry = cur >> digit_bits;
+    }
+    val = static_cast<DoubleDigit>(t[n]) + carry;
+    t[n - 1] = static_cast<Digit>(val);
+    t[n] = static_cast<Digit>(t[n + 1] + (val >> digit_bits));
+  }
+
+  // The result is less than 2 * `m`, at most one subtraction is needed.
+  bool ge{t[n] != 0};
+  if (!ge) {
+    ge = true;
+    for (std::size_t i{n}; i-- > 0;) {
+      if (t[i] != m[i]) {
+        ge = t[i] > m[i];
+        break;
+      }
+    }
+  }
+  if (ge) {
+    Digit borrow{0};
+    for (std::size_t i{0}; i < n; i++) {
+      DoubleDigit val{t[i]};
+      val -= m[i];
+      val -= borrow;
+      t[i] = static_cast<Digit>(val);
+      borrow = (val >> digit_bits) ? 1 : 0;
+    }
+  }
+
+  t.resize(n);
+  return t;
+}
+
+} // namespace ln::kernels
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef LONGNUM_MODULAR_HPP
+#define LONGNUM_MODULAR_HPP
+
+#include <vector>
+
+#include "longnum.hpp"
+
+namespace ln {
+
+// Arithmetic modulo a fixed odd modulus. Montgomery constants are computed
+// once by the constructor, after that multiplication and exponentiation do no
+// division at all.
+//
+// All the numbers are treated as integers: fraction bits are dropped the same
+// way `set_precision(0)` does. Results are in [0, modulus) and have
+// precision of 0.
+class ModContext {
+public:
+  using Digit = Longnum::Digit;
+
+  ~ModContext() = default;
+  ModContext(const ModContext &other) = default;
+  ModContext &operator=(const ModContext &other) = default;
+  ModContext(ModContext &&other) = default;
+  ModContext &operator=(ModContext &&other) = default;
+
+  // Initialization with an odd modulus greater than 1. Throws otherwise.
+  explicit ModContext(const Longnum &modulus);
+
+  // The modulus.
+  Longnum modulus() const;
+
+  // Reduces `x` into [0, modulus). Costs a division if `x` is not less than
+  // the modulus or is negative.
+  Longnum reduce(const Longnum &x) const;
+
+  // Returns `a` * `b` modulo the modulus.
+  Longnum mulmod(const Longnum &a, const Longnum &b) const;
+
+  // Returns `base`^`exp` modulo the modulus, using sliding window
+  // exponentiation. Negative exponents use the modular inverse, throws if it
+  // doesn't exist.
+  Longnum powmod(const Longnum &base, const Longnum &exp) const;
+
+  // Returns x such that `a` * x is 1 modulo the modulus. Throws if `a` and
+  // the modulus are not coprime.
+  Longnum inverse(const Longnum &a) const;
+
+#ifndef LONGNUM_TEST_PRIVATE
+private:
+#endif
+  using Digits = std::vector<Digit>;
+
+  // Montgomery radix is R = 2^(`m.size()` * `digit_bits`).
+  Digits m{};
+
+  // -`m`^(-1) modulo 2^`digit_bits`.
+  Digit m_inv{};
+
+  // R modulo `m`, that is 1 in Montgomery form.
+  Digits one{};
+
+  // R^2 modulo `m`, used to convert into Montgomery form.
+  Digits r2{};
+
+  // Returns `x` modulo `m` as `m.size()` limbs.
+  Digits reduce_digits(const Longnum &x) const;
+
+  // Converts `m.size()` limbs in [0, `m`) to a `Longnum`.
+  static Longnum to_longnum(Digits x);
+
+  // Converts a reduced number to and from Montgomery form.
+  Digits to_mont(const Digits &x) const;
+  Digits from_mont(const Digits &x) const;
+
+  // `x`^`exp` in Montgomery form, `x` is in Montgomery form as well.
+  Digits mont_pow(const Digits &x, const Digits &exp) const;
+};
+
+} // namespace ln
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef LONGNUM_REAL_HPP
+#define LONGNUM_REAL_HPP
+
+#include <concepts>
+#include <functional>
+#include <memory>
+
+#include "longnum.hpp"
+
+namespace ln {
+
+// A lazily evaluated real number. Arithmetic doesn't compute anything, it
+// builds a graph of operations over `Longnum` leaves, and `approx` evaluates
+// it to the precision actually asked for. Every node works out how precise
+// its operands have to be and keeps its best approximation, so asking for
+// more bits later only recomputes what isn't precise enough yet.
+//
+// Copies share the graph, so a value used in many places is evaluated once.
+// The type is not thread-safe, even for copies.
+class Real {
+public:
+  using Precision = Longnum::Precision;
+
+  // Returns an approximation of a number with an error of at most
+  // 2^(-`prec`) for any non-negative `prec`.
+  using Generator = std::function<Longnum(Precision prec)>;
+
+  ~Real() = default;
+  Real(const Real &other) = default;
+  Real &operator=(const Real &other) = default;
+  Real(Real &&other) = default;
+  Real &operator=(Real &&other) = default;
+
+  // Zero.
+  Real();
+
+  // Initialization with an exact value.
+  Real(const Longnum &value);
+
+  // Initialization with an exact integer value.
+  template <std::integral T> Real(T value) : Real(Longnum(value)) {}
+
+  // Initialization with a number known through its approximations.
+  explicit Real(Generator generator);
+
+  // Returns an approximation with an error of at most 2^(-`prec`) and at
+  // least `prec` bits for fraction. Throws if `prec` is negative, or if a
+  // divisor can't be told apart from zero (see `operator/`).
+  Longnum approx(Precision prec) const;
+
+  Real operator-() const;
+
+  friend Real operator+(const Real &a, const Real &b);
+  friend Real operator-(const Real &a, const Real &b);
+  friend Real operator*(const Real &a, const Real &b);
+
+  // Evaluating the quotient needs to tell the sign of `b`, which takes
+  // approximating it until it's clearly not zero. The search gives up and
+  // throws once |`b`| turns out less than 2^(-`max_divisor_precision`).
+  friend Real operator/(const Real &a, const Real &b);
+
+  static constexpr Precision max_divisor_precision{1 << 20};
+
+#ifndef LONGNUM_TEST_PRIVATE
+private:
+#endif
+  struct Node;
+
+  std::shared_ptr<Node> node{};
+
+  explicit Real(std::shared_ptr<Node> node);
+};
+
+} // namespace ln
+
+#endif
@@ -0,0 +1,123 @@
+#ifndef MAPPED_LONGNUM_HPP
+#define MAPPED_LONGNUM_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <istream>
+#include <ostream>
+#include <span>
+
+#include "longnum.hpp"
+
+namespace ln {
+
+// A number whose limbs live in a memory-mapped scratch file instead of the
+// heap, for operands that don't fit into physical memory. The file is created
+// in a given directory and unlinked right away, so it is gone once the number
+// is destroyed (or the process dies).
+//
+// Numbers are read from and written to streams in the `Longnum::write_binary`
+// format, and added, subtracted and multiplied, without ever being held in
+// memory as a whole. Anything else needs a conversion to `Longnum`, which only
+// works for numbers that fit into memory. Needs a POSIX system.
+class MappedLongnum {
+public:
+  using Digit = Longnum::Digit;
+  using Precision = Longnum::Precision;
+
+  // Default block size for `multiply`, 4 MiB worth of limbs.
+  static constexpr std::size_t default_block_limbs{(std::size_t{1} << 22) /
+                                                   sizeof(Digit)};
+
+  ~MappedLongnum();
+  MappedLongnum(const MappedLongnum &other) = delete;
+  MappedLongnum &operator=(const MappedLongnum &other) = delete;
+  MappedLongnum(MappedLongnum &&other) noexcept;
+  MappedLongnum &operator=(MappedLongnum &&other) noexcept;
+
+  // Initialization with zero backed by a scratch file in `dir`. Throws
+  // `std::system_error` if the file can't be created.
+  explicit MappedLongnum(const std::filesystem::path &dir);
+
+  // Initialization with a copy of `other` backed by a scratch file in `dir`.
+  MappedLongnum(const Longnum &other, const std::filesystem::path &dir);
+
+  // Reads a number written by `write_binary` or `Longnum::write_binary` into
+  // a scratch file in `dir`. The data goes through memory in small blocks.
+  // Throws `std::invalid_argument` if it is truncated or malformed.
+  MappedLongnum(std::istream &is, const std::filesystem::path &dir);
+
+  // Writes the number to `os` in the format of `Longnum::write_binary`, in
+  // small blocks.
+  void write_binary(std::ostream &os) const;
+
+  // Copies the number into memory.
+  Longnum to_longnum() const;
+
+  // Number of limbs of the absolute value, there are no leading zeros.
+  std::size_t size() const;
+
+  // Limbs of the absolute value, least significant first.
+  std::span<const Digit> limbs() const;
+
+  // How many bits are used for fraction.
+  Precision get_precision() const;
+
+  // Returns 1 if the number is positive, 0 if zero, and -1 if negative.
+  int sign() const;
+
+  // Exact sum of `a` and `b` stored in a scratch file in `dir`. Max precision
+  // of the operands is kept. Takes a single pass over the limbs.
+  static MappedLongnum add(const MappedLongnum &a, const MappedLongnum &b,
+                           const std::filesystem::path &dir);
+
+  // Exact difference of `a` and `b` stored in a scratch file in `dir`. Max
+  // precision of the operands is kept. Takes a pass over the limbs, and one
+  // more from the top to find the larger absolute value if signs differ.
+  static MappedLongnum subtract(const MappedLongnum &a, const MappedLongnum &b,
+                                const std::filesystem::path &dir);
+
+  // Exact product of `a` and `b` stored in a scratch file in `dir`, its
+  // precision is the sum of the precisions of the operands.
+  //
+  // Products of up to `block_limbs` limbs are computed in memory. Larger ones
+  // go through a number-theoretic transform modulo 2^64 - 2^32 + 1 of the
+  // operands split into 16-bit coefficients, in O(n log n). The coefficients
+  // are kept in scratch files in `dir`, 16 bytes per limb of the product for
+  // each operand, as a matrix of about sqrt(n) rows and columns: rows are
+  // transformed in place, columns are gathered `block_limbs` limbs worth at a
+  // time. Every file is read and written a few times in all.
+  //
+  // Throws if `block_limbs` is 0 or the product has more than 2^31 limbs.
+  static MappedLongnum multiply(const MappedLongnum &a, const MappedLongnum &b,
+                                const std::filesystem::path &dir,
+                                std::size_t block_limbs = default_block_limbs);
+
+#ifndef LONGNUM_TEST_PRIVATE
+private:
+#endif
+  int fd{-1};
+  Digit *data{nullptr};
+  std::size_t length{};
+  Precision precision{};
+  bool negative{};
+
+  // Changes the number of limbs to `size`, growing or shrinking the file.
+  // New limbs are zero.
+  void resize(std::size_t size);
+
+  // Unmaps and closes the file.
+  void release();
+
+  // Tells the system how the limbs are going to be accessed, see `madvise`.
+  // Failures are ignored, as this is only a hint.
+  void advise(int advice) const;
+
+  // Sum of `a` and `b` with the sign of `b` flipped if `flip`.
+  static MappedLongnum combine(const MappedLongnum &a, const MappedLongnum &b,
+                               const std::filesystem::path &dir, bool flip);
+};
+
+} // namespace ln
+
+#endif
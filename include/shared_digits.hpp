@@ -0,0 +1,211 @@
+#ifndef SHARED_DIGITS_HPP
+#define SHARED_DIGITS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "longnum_kernels.hpp"
+
+namespace ln {
+
+// A limb vector shared between copies and copied only when one of them is
+// about to change it (copy-on-write), so copying a number is O(1).
+//
+// Reading goes through the const members, including the conversion to
+// `const kernels::Digits &` that lets the limbs go straight into kernels.
+// Writing needs `unshared()`, which makes the limbs owned by this object
+// alone first. References it returns stay valid until the object is copied,
+// assigned to or destroyed.
+//
+// The reference count is atomic at runtime, so copies may live in different
+// threads, and a plain counter during constant evaluation.
+class SharedDigits {
+public:
+  using Digit = kernels::Digit;
+  using Digits = kernels::Digits;
+
+  constexpr ~SharedDigits();
+  constexpr SharedDigits(const SharedDigits &other);
+  constexpr SharedDigits &operator=(const SharedDigits &other);
+  constexpr SharedDigits(SharedDigits &&other) noexcept;
+  constexpr SharedDigits &operator=(SharedDigits &&other) noexcept;
+
+  // Initialization with no limbs.
+  constexpr SharedDigits() = default;
+
+  // Initialization with the given limbs.
+  constexpr SharedDigits(Digits digits);
+
+  // Replaces the limbs with the given ones, the old ones are released.
+  constexpr SharedDigits &operator=(Digits digits);
+
+  constexpr operator const Digits &() const;
+  constexpr const Digits &get() const;
+
+  constexpr std::size_t size() const;
+  constexpr bool empty() const;
+  constexpr Digit operator[](std::size_t index) const;
+  constexpr Digit back() const;
+  constexpr Digits::const_iterator begin() const;
+  constexpr Digits::const_iterator end() const;
+
+  // Returns the limbs for writing, copying them first if they are shared.
+  constexpr Digits &unshared();
+
+  // Whether the limbs are shared with another object.
+  constexpr bool shared() const;
+
+#ifndef LONGNUM_TEST_PRIVATE
+private:
+#endif
+  struct Buffer {
+    Digits digits{};
+    alignas(std::atomic_ref<std::size_t>::required_alignment)
+        std::size_t refs{1};
+  };
+
+  // No limbs are kept as a null buffer, so that zeros don't allocate.
+  Buffer *buffer{};
+
+  // What a null buffer reads as.
+  static constexpr Digits no_digits{};
+
+  static constexpr void acquire(Buffer *buffer);
+
+  // Drops the reference to `buffer` and deletes it if it was the last one.
+  constexpr void release();
+
+  constexpr std::size_t refs() const;
+};
+
+} // namespace ln
+
+constexpr ln::SharedDigits::~SharedDigits() { release(); }
+
+constexpr ln::SharedDigits::SharedDigits(const SharedDigits &other)
+    : buffer{other.buffer} {
+  acquire(buffer);
+}
+
+constexpr ln::SharedDigits &
+ln::SharedDigits::operator=(const SharedDigits &other) {
+  if (buffer != other.buffer) {
+    acquire(other.buffer);
+    release();
+    buffer = other.buffer;
+  }
+  return *this;
+}
+
+constexpr ln::SharedDigits::SharedDigits(SharedDigits &&other) noexcept
+    : buffer{std::exchange(other.buffer, nullptr)} {}
+
+constexpr ln::SharedDigits &
+ln::SharedDigits::operator=(SharedDigits &&other) noexcept {
+  if (this != &other) {
+    release();
+    buffer = std::exchange(other.buffer, nullptr);
+  }
+  return *this;
+}
+
+constexpr ln::SharedDigits::SharedDigits(Digits digits) {
+  if (!digits.empty()) {
+    buffer = new Buffer{std::move(digits)};
+  }
+}
+
+constexpr ln::SharedDigits &ln::SharedDigits::operator=(Digits digits) {
+  if (buffer != nullptr && refs() == 1) {
+    buffer->digits = std::move(digits);
+    return *this;
+  }
+  return *this = SharedDigits{std::move(digits)};
+}
+
+constexpr ln::SharedDigits::operator const Digits &() const { return get(); }
+
+constexpr const ln::SharedDigits::Digits &ln::SharedDigits::get() const {
+  if (buffer == nullptr) {
+    return no_digits;
+  }
+  return buffer->digits;
+}
+
+constexpr std::size_t ln::SharedDigits::size() const { return get().size(); }
+
+constexpr bool ln::SharedDigits::empty() const { return get().empty(); }
+
+constexpr ln::SharedDigits::Digit
+ln::SharedDigits::operator[](std::size_t index) const {
+  return get()[index];
+}
+
+constexpr ln::SharedDigits::Digit ln::SharedDigits::back() const {
+  return get().back();
+}
+
+constexpr ln::SharedDigits::Digits::const_iterator
+ln::SharedDigits::begin() const {
+  return get().begin();
+}
+
+constexpr ln::SharedDigits::Digits::const_iterator
+ln::SharedDigits::end() const {
+  return get().end();
+}
+
+constexpr ln::SharedDigits::Digits &ln::SharedDigits::unshared() {
+  if (buffer == nullptr) {
+    buffer = new Buffer{};
+  } else if (refs() != 1) {
+    auto *copy{new Buffer{buffer->digits}};
+    release();
+    buffer = copy;
+  }
+  return buffer->digits;
+}
+
+constexpr bool ln::SharedDigits::shared() const {
+  return buffer != nullptr && refs() != 1;
+}
+
+constexpr void ln::SharedDigits::acquire(Buffer *buffer) {
+  if (buffer == nullptr) {
+    return;
+  }
+  if (std::is_constant_evaluated()) {
+    buffer->refs++;
+  } else {
+    std::atomic_ref{buffer->refs}.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+constexpr void ln::SharedDigits::release() {
+  if (buffer == nullptr) {
+    return;
+  }
+
+  bool last{};
+  if (std::is_constant_evaluated()) {
+    last = --buffer->refs == 0;
+  } else {
+    last = std::atomic_ref{buffer->refs}.fetch_sub(
+               1, std::memory_order_acq_rel) == 1;
+  }
+  if (last) {
+    delete buffer;
+  }
+  buffer = nullptr;
+}
+
+constexpr std::size_t ln::SharedDigits::refs() const {
+  if (std::is_constant_evaluated()) {
+    return buffer->refs;
+  }
+  return std::atomic_ref{buffer->refs}.load(std::memory_order_acquire);
+}
+
+#endif
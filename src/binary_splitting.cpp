@@ -0,0 +1,222 @@
+#include "binary_splitting.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <span>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <csignal>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace ln {
+
+namespace {
+
+[[noreturn]] void throw_errno(const char *what) {
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+// Writes all of `data` to `fd`. Returns false on failure.
+bool write_all(int fd, const std::string &data) {
+  std::size_t done{0};
+  while (done < data.size()) {
+    const auto n{::write(fd, data.data() + done, data.size() - done)};
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    done += static_cast<std::size_t>(n);
+  }
+  return true;
+}
+
+// Reads from `fd` until the other end is closed.
+std::string read_all(int fd) {
+  std::string res{};
+  std::vector<char> buf(1 << 16);
+  while (true) {
+    const auto n{::read(fd, buf.data(), buf.size())};
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0) {
+      throw_errno("Can't read from a worker");
+    }
+    if (n == 0) {
+      return res;
+    }
+    res.append(buf.data(), static_cast<std::size_t>(n));
+  }
+}
+
+// A forked worker process and the socket its result comes from. A worker
+// that is still running when this is destroyed is killed.
+class Worker {
+public:
+  ~Worker() {
+    if (fd >= 0) {
+      ::close(fd);
+    }
+    if (pid > 0) {
+      ::kill(pid, SIGKILL);
+      reap();
+    }
+  }
+
+  Worker(const Worker &other) = delete;
+  Worker &operator=(const Worker &other) = delete;
+
+  Worker(Worker &&other) noexcept
+      : pid{std::exchange(other.pid, -1)}, fd{std::exchange(other.fd, -1)} {}
+
+  Worker &operator=(Worker &&other) = delete;
+
+  Worker(pid_t pid, int fd) : pid{pid}, fd{fd} {}
+
+  // Waits for the result, returns false if the worker didn't succeed.
+  bool finish(SplitResult &res) {
+    const auto data{read_all(fd)};
+    ::close(fd);
+    fd = -1;
+
+    const auto status{reap()};
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      return false;
+    }
+
+    std::istringstream is{data};
+    res.p = Longnum::read_binary(is);
+    res.q = Longnum::read_binary(is);
+    res.t = Longnum::read_binary(is);
+    return true;
+  }
+
+private:
+  pid_t pid{-1};
+  int fd{-1};
+
+  int reap() {
+    int status{};
+    while (::waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+    }
+    pid = -1;
+    return status;
+  }
+};
+
+// Runs in a forked worker: sums the range and sends the result to `fd`.
+[[noreturn]] void work(const SplitSeries &series, std::uint64_t first,
+                       std::uint64_t last, int fd) {
+  bool ok{false};
+  try {
+    const auto res{binary_split(series, first, last)};
+    std::ostringstream os{};
+    res.p.write_binary(os);
+    res.q.write_binary(os);
+    res.t.write_binary(os);
+    ok = write_all(fd, std::move(os).str());
+  } catch (...) {
+  }
+  ::_exit(ok ? 0 : 1);
+}
+
+SplitResult merge_all(std::span<const SplitResult> results) {
+  if (results.size() == 1) {
+    return results.front();
+  }
+  const auto mid{results.size() / 2};
+  return merge(merge_all(results.first(mid)), merge_all(results.subspan(mid)));
+}
+
+} // namespace
+
+SplitResult merge(const SplitResult &left, const SplitResult &right) {
+  WorkingPrecision::Suspend exact{};
+  SplitResult res{};
+  res.p = left.p * right.p;
+  res.q = left.q * right.q;
+  res.t = left.t * right.q + left.p * right.t;
+  return res;
+}
+
+SplitResult binary_split(const SplitSeries &series, std::uint64_t first,
+                         std::uint64_t last) {
+  if (first >= last) {
+    return {};
+  }
+
+  if (last - first == 1) {
+    WorkingPrecision::Suspend exact{};
+    SplitResult res{};
+    res.p = series.p(first);
+    res.q = series.q(first);
+    res.t = series.a(first) * res.p;
+    return res;
+  }
+
+  const auto mid{first + (last - first) / 2};
+  return merge(binary_split(series, first, mid),
+               binary_split(series, mid, last));
+}
+
+SplitResult distributed_split(const SplitSeries &series, std::uint64_t first,
+                              std::uint64_t last, std::size_t workers) {
+  if (workers == 0) {
+    throw std::invalid_argument("At least one worker is needed");
+  }
+  if (first >= last) {
+    return {};
+  }
+
+  const auto count{last - first};
+  workers = static_cast<std::size_t>(
+      std::min<std::uint64_t>(workers, count));
+
+  std::vector<Worker> started{};
+  started.reserve(workers);
+  for (std::size_t i{0}; i < workers; i++) {
+    const auto lo{first + count * i / workers};
+    const auto hi{first + count * (i + 1) / workers};
+
+    std::array<int, 2> fds{};
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds.data()) < 0) {
+      throw_errno("Can't create a socket pair");
+    }
+
+    const auto pid{::fork()};
+    if (pid < 0) {
+      const auto err{errno};
+      ::close(fds[0]);
+      ::close(fds[1]);
+      errno = err;
+      throw_errno("Can't start a worker");
+    }
+    if (pid == 0) {
+      ::close(fds[0]);
+      work(series, lo, hi, fds[1]);
+    }
+
+    ::close(fds[1]);
+    started.emplace_back(pid, fds[0]);
+  }
+
+  std::vector<SplitResult> results(workers);
+  for (std::size_t i{0}; i < workers; i++) {
+    if (!started[i].finish(results[i])) {
+      throw std::runtime_error("Worker process failed");
+    }
+  }
+
+  return merge_all(results);
+}
+
+} // namespace ln
@@ -0,0 +1,536 @@
+#include "decimal_longnum.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <span>
+#include <stdexcept>
+
+namespace ln {
+
+namespace {
+
+using Limb = DecimalLongnum::Limb;
+using Limbs = DecimalLongnum::Limbs;
+using kernels::Digit;
+using kernels::Digits;
+
+constexpr auto limb_digits{DecimalLongnum::limb_digits};
+constexpr auto limb_radix{DecimalLongnum::limb_radix};
+
+// 10^i for every i below `limb_digits`.
+constexpr auto small_pow10{[] {
+  std::array<Limb, limb_digits> res{};
+  Limb pow{1};
+  for (auto &x : res) {
+    x = pow;
+    pow *= 10;
+  }
+  return res;
+}()};
+
+// Numbers that small are converted with repeated single-limb operations.
+constexpr std::size_t leaf_limbs{32};
+
+void trim(Limbs &a) {
+  while (!a.empty() && a.back() == 0) {
+    a.pop_back();
+  }
+}
+
+std::strong_ordering compare(const Limbs &a, const Limbs &b) {
+  if (a.size() != b.size()) {
+    return a.size() <=> b.size();
+  }
+  for (std::size_t i{a.size()}; i-- > 0;) {
+    if (a[i] != b[i]) {
+      return a[i] <=> b[i];
+    }
+  }
+  return std::strong_ordering::equal;
+}
+
+// Adds `b` to `a` in place.
+void add_to(Limbs &a, const Limbs &b) {
+  if (a.size() < b.size()) {
+    a.resize(b.size(), 0);
+  }
+
+  Limb carry{0};
+  for (std::size_t i{0}; i < a.size() && (carry != 0 || i < b.size()); i++) {
+    Limb val{a[i] + carry + (i < b.size() ? b[i] : Limb{0})};
+    carry = val >= limb_radix ? 1 : 0;
+    a[i] = val - carry * limb_radix;
+  }
+  if (carry != 0) {
+    a.push_back(carry);
+  }
+}
+
+// Subtracts `b` from `a` in place. `a` must not be less than `b`.
+void sub_from(Limbs &a, const Limbs &b) {
+  Limb borrow{0};
+  for (std::size_t i{0}; i < a.size() && (borrow != 0 || i < b.size()); i++) {
+    const Limb sub{borrow + (i < b.size() ? b[i] : Limb{0})};
+    borrow = a[i] < sub ? 1 : 0;
+    a[i] = a[i] + borrow * limb_radix - sub;
+  }
+  trim(a);
+}
+
+// Multiplies `a` by `m` in place. `m` must be less than `limb_radix`.
+void mul_small(Limbs &a, Limb m) {
+  std::uint64_t carry{0};
+  for (auto &x : a) {
+    const std::uint64_t val{static_cast<std::uint64_t>(x) * m + carry};
+    x = static_cast<Limb>(val % limb_radix);
+    carry = val / limb_radix;
+  }
+  if (carry != 0) {
+    a.push_back(static_cast<Limb>(carry));
+  }
+  trim(a);
+}
+
+// Divides `a` by `d` in place, rounding down. `d` must not be 0.
+void div_small(Limbs &a, Limb d) {
+  std::uint64_t rem{0};
+  for (std::size_t i{a.size()}; i-- > 0;) {
+    const std::uint64_t cur{rem * limb_radix + a[i]};
+    a[i] = static_cast<Limb>(cur / d);
+    rem = cur % d;
+  }
+  trim(a);
+}
+
+// Schoolbook multiplication. A partial sum stays below 2^64 because every
+// product is below 10^18 and the carry is folded in right away.
+Limbs mul(const Limbs &a, const Limbs &b) {
+  if (a.empty() || b.empty()) {
+    return {};
+  }
+
+  Limbs res(a.size() + b.size(), 0);
+  for (std::size_t i{0}; i < a.size(); i++) {
+    if (a[i] == 0) {
+      continue;
+    }
+    std::uint64_t carry{0};
+    for (std::size_t j{0}; j < b.size(); j++) {
+      const std::uint64_t val{static_cast<std::uint64_t>(a[i]) * b[j] +
+                              res[i + j] + carry};
+      res[i + j] = static_cast<Limb>(val % limb_radix);
+      carry = val / limb_radix;
+    }
+    res[i + b.size()] = static_cast<Limb>(carry);
+  }
+
+  trim(res);
+  return res;
+}
+
+// Multiplies `a` by 10^`exp` in place.
+void mul_pow10(Limbs &a, std::uint64_t exp) {
+  if (a.empty()) {
+    return;
+  }
+  a.insert(a.begin(), exp / limb_digits, 0);
+  mul_small(a, small_pow10[exp % limb_digits]);
+}
+
+// Divides `a` by 10^`exp` in place, rounding down.
+void div_pow10(Limbs &a, std::uint64_t exp) {
+  const auto drop{std::min<std::uint64_t>(exp / limb_digits, a.size())};
+  a.erase(a.begin(), a.begin() + static_cast<std::ptrdiff_t>(drop));
+  div_small(a, small_pow10[exp % limb_digits]);
+}
+
+Digits to_digits(std::uint64_t x) {
+  Digits res{};
+  for (; x != 0; x >>= kernels::digit_bits) {
+    res.push_back(static_cast<Digit>(x));
+  }
+  return res;
+}
+
+// `base`^`exp` in binary limbs.
+Digits power(Digit base, std::uint64_t exp) {
+  Digits res{1};
+  Digits sq{base};
+  kernels::trim(sq);
+  while (exp != 0) {
+    if (exp & 1) {
+      res = kernels::mul(res, sq);
+    }
+    exp >>= 1;
+    if (exp != 0) {
+      sq = kernels::mul(sq, sq);
+    }
+  }
+  return res;
+}
+
+// Binary limbs may be narrower than decimal ones, then `limb_radix` takes
+// more than one of them.
+constexpr bool radix_fits{limb_radix <= std::numeric_limits<Digit>::max()};
+
+// Returns `a` * `limb_radix` + `add`.
+void mul_radix(Digits &a, Limb add) {
+  if constexpr (radix_fits) {
+    kernels::mul_small(a, static_cast<Digit>(limb_radix),
+                       static_cast<Digit>(add));
+  } else {
+    a = kernels::add(kernels::mul(a, to_digits(limb_radix)), to_digits(add));
+  }
+}
+
+// Divides `a` by `limb_radix` in place and returns the remainder.
+Limb div_radix(Digits &a) {
+  if constexpr (radix_fits) {
+    return kernels::div_small(a, static_cast<Digit>(limb_radix));
+  } else {
+    auto [quot, rem] = kernels::div_mod(a, to_digits(limb_radix));
+    a = std::move(quot);
+    std::uint64_t res{0};
+    for (std::size_t i{rem.size()}; i-- > 0;) {
+      res = res << kernels::digit_bits | rem[i];
+    }
+    return static_cast<Limb>(res);
+  }
+}
+
+// Powers `limb_radix`^(2^k) in binary limbs used to split numbers in halves,
+// computed on demand.
+class RadixPowers {
+public:
+  const Digits &operator()(std::size_t level) {
+    if (powers.empty()) {
+      powers.push_back(to_digits(limb_radix));
+    }
+    while (powers.size() <= level) {
+      powers.push_back(kernels::mul(powers.back(), powers.back()));
+    }
+    return powers[level];
+  }
+
+private:
+  std::vector<Digits> powers{};
+};
+
+// The level of the split of `size` limbs, the low part takes 2^level of
+// them.
+std::size_t split_level(std::size_t size) {
+  std::size_t level{0};
+  while ((std::size_t{2} << level) < size) {
+    level++;
+  }
+  return level;
+}
+
+// Divide-and-conquer conversion from decimal limbs: the high and the low
+// parts are converted recursively and joined as high * 10^(...) + low.
+Digits to_binary(std::span<const Limb> limbs, RadixPowers &power) {
+  if (limbs.size() <= leaf_limbs) {
+    Digits res{};
+    for (std::size_t i{limbs.size()}; i-- > 0;) {
+      mul_radix(res, limbs[i]);
+    }
+    return res;
+  }
+
+  const auto level{split_level(limbs.size())};
+  const auto low{std::size_t{1} << level};
+  return kernels::add(
+      kernels::mul(to_binary(limbs.subspan(low), power), power(level)),
+      to_binary(limbs.first(low), power));
+}
+
+// Divide-and-conquer conversion to decimal limbs, the reverse of
+// `to_binary`. `num` must be less than `limb_radix`^`out.size()`.
+void to_decimal(const Digits &num, std::span<Limb> out, RadixPowers &power) {
+  if (out.size() <= leaf_limbs) {
+    Digits rest{num};
+    for (auto &x : out) {
+      x = rest.empty() ? 0 : div_radix(rest);
+    }
+    return;
+  }
+
+  const auto level{split_level(out.size())};
+  const auto low{std::size_t{1} << level};
+  auto [hi, lo] = kernels::div_mod(num, power(level));
+  to_decimal(lo, out.first(low), power);
+  to_decimal(hi, out.subspan(low), power);
+}
+
+Limbs to_decimal(const Digits &num) {
+  // A decimal limb holds more than 29 bits, as 2^29 < 10^9.
+  Limbs res(num.size() * kernels::digit_bits / 29 + 1, 0);
+  RadixPowers power{};
+  to_decimal(num, res, power);
+  trim(res);
+  return res;
+}
+
+Digits to_binary(const Limbs &limbs) {
+  RadixPowers power{};
+  return to_binary(std::span<const Limb>{limbs}, power);
+}
+
+bool all_digits(std::string_view str) {
+  return std::all_of(str.begin(), str.end(),
+                     [](char c) { return c >= '0' && c <= '9'; });
+}
+
+} // namespace
+
+DecimalLongnum::DecimalLongnum(const Longnum &other)
+    : negative{other.negative} {
+  const auto prec{other.get_precision()};
+  if (prec >= 0) {
+    // x * 10^prec = digits * 5^prec
+    scale = static_cast<Scale>(prec);
+    limbs = to_decimal(
+        kernels::mul(other.digits, power(5, static_cast<std::uint64_t>(prec))));
+  } else {
+    const auto sh{static_cast<std::size_t>(-static_cast<std::int64_t>(prec))};
+    limbs = to_decimal(kernels::shift_left(other.digits, sh));
+  }
+  normalize();
+}
+
+Longnum DecimalLongnum::to_longnum(Longnum::Precision prec) const {
+  if (prec < 0) {
+    throw std::invalid_argument("Precision must be non-negative");
+  }
+
+  // The result is floor(limbs * 2^`prec` / 10^`scale`).
+  auto num{
+      kernels::shift_left(to_binary(limbs), static_cast<std::size_t>(prec))};
+  if (scale != 0) {
+    num = kernels::div_mod(num, power(10, scale)).first;
+  }
+
+  Longnum res{};
+  res.digits = std::move(num);
+  res.precision = prec;
+  res.negative = negative;
+  res.remove_leading_zeros();
+  return res;
+}
+
+DecimalLongnum DecimalLongnum::from_string(std::string_view str) {
+  DecimalLongnum res{};
+  if (!str.empty() && (str[0] == '-' || str[0] == '+')) {
+    res.negative = str[0] == '-';
+    str.remove_prefix(1);
+  }
+
+  const auto point{str.find('.')};
+  const auto int_part{str.substr(0, point)};
+  const auto frac_part{point == std::string_view::npos
+                           ? std::string_view{}
+                           : str.substr(point + 1)};
+  if (int_part.empty() || !all_digits(int_part) ||
+      (point != std::string_view::npos &&
+       (frac_part.empty() || !all_digits(frac_part)))) {
+    throw std::invalid_argument("Not a decimal number");
+  }
+  if (frac_part.size() > std::numeric_limits<Scale>::max()) {
+    throw std::invalid_argument("Scale is out of range");
+  }
+  res.scale = static_cast<Scale>(frac_part.size());
+
+  // Limbs are filled from the least significant digit, which is the last one
+  // of the fraction if there is a fraction.
+  const auto total{int_part.size() + frac_part.size()};
+  const auto digit_at{[&](std::size_t i) {
+    return i < int_part.size() ? int_part[i] : frac_part[i - int_part.size()];
+  }};
+  res.limbs.assign((total + limb_digits - 1) / limb_digits, 0);
+  for (std::size_t i{0}; i < total; i++) {
+    const auto pos{total - 1 - i};
+    res.limbs[i / limb_digits] +=
+        static_cast<Limb>(digit_at(pos) - '0') * small_pow10[i % limb_digits];
+  }
+
+  res.normalize();
+  return res;
+}
+
+std::string DecimalLongnum::to_string() const {
+  std::string res{};
+  res.reserve(limbs.size() * limb_digits + scale + 3);
+  if (negative) {
+    res += '-';
+  }
+
+  // All limbs but the top one are padded to `limb_digits` digits, and the
+  // whole is padded so that there is a digit before the point.
+  const auto digits{
+      limbs.empty()
+          ? std::size_t{0}
+          : (limbs.size() - 1) * limb_digits +
+                std::to_string(limbs.back()).size()};
+  if (digits <= scale) {
+    res.append(scale + 1 - digits, '0');
+  }
+  for (std::size_t i{limbs.size()}; i-- > 0;) {
+    auto limb{std::to_string(limbs[i])};
+    if (i + 1 != limbs.size()) {
+      res.append(limb_digits - limb.size(), '0');
+    }
+    res += limb;
+  }
+
+  if (scale != 0) {
+    res.insert(res.end() - scale, '.');
+  }
+  return res;
+}
+
+std::string DecimalLongnum::to_string(Scale fp_digits) const {
+  DecimalLongnum x{*this};
+  x.set_scale(fp_digits);
+  return x.to_string();
+}
+
+DecimalLongnum::Scale DecimalLongnum::get_scale() const { return scale; }
+
+DecimalLongnum &DecimalLongnum::set_scale(Scale new_scale) {
+  if (new_scale > scale) {
+    mul_pow10(limbs, new_scale - scale);
+  } else {
+    div_pow10(limbs, scale - new_scale);
+  }
+  scale = new_scale;
+  normalize();
+  return *this;
+}
+
+int DecimalLongnum::sign() const {
+  if (limbs.empty()) {
+    return 0;
+  }
+  return negative ? -1 : 1;
+}
+
+std::strong_ordering
+DecimalLongnum::operator<=>(const DecimalLongnum &other) const {
+  if (sign() != other.sign()) {
+    return sign() <=> other.sign();
+  }
+
+  const auto common{std::max(scale, other.scale)};
+  auto a{limbs};
+  auto b{other.limbs};
+  mul_pow10(a, common - scale);
+  mul_pow10(b, common - other.scale);
+  return negative ? compare(b, a) : compare(a, b);
+}
+
+bool DecimalLongnum::operator==(const DecimalLongnum &other) const {
+  return (*this <=> other) == 0;
+}
+
+DecimalLongnum DecimalLongnum::operator+(const DecimalLongnum &other) const {
+  DecimalLongnum x{*this};
+  return x += other;
+}
+
+DecimalLongnum &DecimalLongnum::operator+=(const DecimalLongnum &other) {
+  add(other, false);
+  return *this;
+}
+
+DecimalLongnum DecimalLongnum::operator-() const {
+  DecimalLongnum x{*this};
+  x.negative = !x.negative;
+  x.normalize();
+  return x;
+}
+
+DecimalLongnum DecimalLongnum::operator-(const DecimalLongnum &other) const {
+  DecimalLongnum x{*this};
+  return x -= other;
+}
+
+DecimalLongnum &DecimalLongnum::operator-=(const DecimalLongnum &other) {
+  add(other, true);
+  return *this;
+}
+
+DecimalLongnum DecimalLongnum::operator*(const DecimalLongnum &other) const {
+  DecimalLongnum x{*this};
+  return x *= other;
+}
+
+DecimalLongnum &DecimalLongnum::operator*=(const DecimalLongnum &other) {
+  if (scale > std::numeric_limits<Scale>::max() - other.scale) {
+    throw std::invalid_argument("Scale is out of range");
+  }
+
+  limbs = mul(limbs, other.limbs);
+  scale += other.scale;
+  negative = negative != other.negative;
+  normalize();
+  return *this;
+}
+
+DecimalLongnum DecimalLongnum::operator/(const DecimalLongnum &other) const {
+  DecimalLongnum x{*this};
+  return x /= other;
+}
+
+DecimalLongnum &DecimalLongnum::operator/=(const DecimalLongnum &other) {
+  if (other.sign() == 0) {
+    throw std::invalid_argument("Division by zero is not allowed");
+  }
+
+  // With a and b being the limbs, the quotient with the larger scale s is
+  // a * 10^(s - `scale` + `other.scale`) / b.
+  const auto new_scale{std::max(scale, other.scale)};
+  mul_pow10(limbs, std::uint64_t{new_scale} - scale + other.scale);
+  limbs =
+      to_decimal(kernels::div_mod(to_binary(limbs), to_binary(other.limbs))
+                     .first);
+  scale = new_scale;
+  negative = negative != other.negative;
+  normalize();
+  return *this;
+}
+
+void DecimalLongnum::normalize() {
+  trim(limbs);
+  if (limbs.empty()) {
+    negative = false;
+  }
+}
+
+void DecimalLongnum::add(const DecimalLongnum &other, bool subtract) {
+  auto rhs{other.limbs};
+  if (scale < other.scale) {
+    mul_pow10(limbs, other.scale - scale);
+    scale = other.scale;
+  } else {
+    mul_pow10(rhs, scale - other.scale);
+  }
+
+  if (negative == (other.negative != subtract)) {
+    add_to(limbs, rhs);
+  } else if (compare(limbs, rhs) >= 0) {
+    sub_from(limbs, rhs);
+  } else {
+    sub_from(rhs, limbs);
+    limbs = std::move(rhs);
+    negative = !negative;
+  }
+  normalize();
+}
+
+std::ostream &operator<<(std::ostream &os, const DecimalLongnum &num) {
+  return os << num.to_string(
+             static_cast<DecimalLongnum::Scale>(os.precision()));
+}
+
+} // namespace ln
@@ -0,0 +1,269 @@
+#include "float_longnum.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <stdexcept>
+
+namespace ln {
+
+namespace {
+
+using kernels::Digits;
+
+constexpr auto digit_bits{kernels::digit_bits};
+
+std::size_t bit_length(const Digits &x) {
+  if (x.empty()) {
+    return 0;
+  }
+  return x.size() * digit_bits - std::countl_zero(x.back());
+}
+
+std::size_t trailing_zeros(const Digits &x) {
+  std::size_t res{0};
+  for (auto digit : x) {
+    if (digit != 0) {
+      return res + std::countr_zero(digit);
+    }
+    res += digit_bits;
+  }
+  return res;
+}
+
+} // namespace
+
+FloatLongnum::FloatLongnum(const Longnum &other, std::size_t bits)
+    : mant{other.digits}, exp{-other.get_precision()},
+      negative{other.negative}, bits{bits} {
+  if (bits == 0) {
+    throw std::invalid_argument("Bit cap must not be 0");
+  }
+  normalize();
+}
+
+FloatLongnum::operator Longnum() const {
+  Longnum res{};
+  res.digits = mant;
+  res.negative = negative;
+  if (exp >= 0) {
+    res <<= static_cast<std::size_t>(exp);
+    return res;
+  }
+
+  if (-exp > std::numeric_limits<Precision>::max()) {
+    throw std::invalid_argument("The number is too small for a Longnum");
+  }
+  res.precision = static_cast<Precision>(-exp);
+  return res;
+}
+
+std::string FloatLongnum::to_string(std::uint32_t fp_digits) const {
+  return static_cast<Longnum>(*this).to_string(fp_digits);
+}
+
+std::size_t FloatLongnum::get_bits() const { return bits; }
+
+FloatLongnum &FloatLongnum::set_bits(std::size_t new_bits) {
+  if (new_bits == 0) {
+    throw std::invalid_argument("Bit cap must not be 0");
+  }
+  bits = new_bits;
+  normalize();
+  return *this;
+}
+
+Longnum FloatLongnum::mantissa() const {
+  Longnum res{};
+  res.digits = mant;
+  res.negative = negative;
+  return res;
+}
+
+FloatLongnum::Exponent FloatLongnum::exponent() const { return exp; }
+
+int FloatLongnum::sign() const {
+  if (mant.empty()) {
+    return 0;
+  }
+  return negative ? -1 : 1;
+}
+
+std::strong_ordering
+FloatLongnum::operator<=>(const FloatLongnum &other) const {
+  if (sign() != other.sign()) {
+    return sign() <=> other.sign();
+  }
+  if (sign() == 0) {
+    return std::strong_ordering::equal;
+  }
+
+  auto abs_order{top() <=> other.top()};
+  if (abs_order == 0) {
+    // Same magnitude, so the exponents differ by less than the bit caps.
+    const auto low{std::min(exp, other.exp)};
+    abs_order = kernels::compare(
+        kernels::shift_left(mant, static_cast<std::size_t>(exp - low)),
+        kernels::shift_left(other.mant,
+                            static_cast<std::size_t>(other.exp - low)));
+  }
+  return negative ? 0 <=> abs_order : abs_order;
+}
+
+bool FloatLongnum::operator==(const FloatLongnum &other) const {
+  return (*this <=> other) == 0;
+}
+
+FloatLongnum FloatLongnum::operator+(const FloatLongnum &other) const {
+  FloatLongnum res{*this};
+  return res += other;
+}
+
+FloatLongnum &FloatLongnum::operator+=(const FloatLongnum &other) {
+  add(other, false);
+  return *this;
+}
+
+FloatLongnum FloatLongnum::operator-() const {
+  FloatLongnum res{*this};
+  res.negative = !res.negative;
+  res.normalize();
+  return res;
+}
+
+FloatLongnum FloatLongnum::operator-(const FloatLongnum &other) const {
+  FloatLongnum res{*this};
+  return res -= other;
+}
+
+FloatLongnum &FloatLongnum::operator-=(const FloatLongnum &other) {
+  add(other, true);
+  return *this;
+}
+
+FloatLongnum FloatLongnum::operator*(const FloatLongnum &other) const {
+  FloatLongnum res{*this};
+  return res *= other;
+}
+
+FloatLongnum &FloatLongnum::operator*=(const FloatLongnum &other) {
+  mant = kernels::mul(mant, other.mant);
+  exp += other.exp;
+  negative = negative != other.negative;
+  bits = std::max(bits, other.bits);
+  normalize();
+  return *this;
+}
+
+FloatLongnum FloatLongnum::operator/(const FloatLongnum &other) const {
+  FloatLongnum res{*this};
+  return res /= other;
+}
+
+FloatLongnum &FloatLongnum::operator/=(const FloatLongnum &other) {
+  if (other.sign() == 0) {
+    throw std::invalid_argument("Division by zero");
+  }
+
+  bits = std::max(bits, other.bits);
+  if (sign() != 0) {
+    // Scale the dividend so that the quotient has at least `bits` bits.
+    const auto a_len{bit_length(mant)};
+    const auto b_len{bit_length(other.mant)};
+    const auto sh{bits + b_len + 1 > a_len ? bits + b_len + 1 - a_len : 0};
+
+    mant = kernels::div_mod(kernels::shift_left(mant, sh), other.mant).first;
+    exp -= other.exp + static_cast<Exponent>(sh);
+    negative = negative != other.negative;
+  }
+  normalize();
+  return *this;
+}
+
+void FloatLongnum::normalize() {
+  kernels::trim(mant);
+  if (mant.empty()) {
+    exp = 0;
+    negative = false;
+    return;
+  }
+
+  const auto len{bit_length(mant)};
+  if (len > bits) {
+    mant = kernels::shift_right(mant, len - bits);
+    exp += static_cast<Exponent>(len - bits);
+  }
+
+  const auto zeros{trailing_zeros(mant)};
+  mant = kernels::shift_right(mant, zeros);
+  exp += static_cast<Exponent>(zeros);
+}
+
+FloatLongnum::Exponent FloatLongnum::top() const {
+  return exp + static_cast<Exponent>(bit_length(mant));
+}
+
+void FloatLongnum::add(const FloatLongnum &other, bool subtract) {
+  const auto cap{std::max(bits, other.bits)};
+  const bool other_negative{other.negative != subtract};
+
+  if (other.sign() == 0 || sign() == 0) {
+    if (sign() == 0) {
+      mant = other.mant;
+      exp = other.exp;
+      negative = other_negative;
+    }
+    bits = cap;
+    normalize();
+    return;
+  }
+
+  const bool this_big{top() >= other.top()};
+  const auto &big{this_big ? *this : other};
+  const auto &small{this_big ? other : *this};
+  const bool big_negative{this_big ? negative : other_negative};
+  const bool small_negative{this_big ? other_negative : negative};
+
+  // Bits of the smaller operand that are far below the `cap` bits of the
+  // result only matter through whether they are 0. Mantissas are odd, so
+  // they are not, and they are replaced with a single unit (a sticky bit)
+  // at position `low`. Two guard bits make the truncation come out right.
+  auto low{std::min(big.exp, small.exp)};
+  const auto limit{big.top() - static_cast<Exponent>(cap) - 2};
+  bool sticky{false};
+  Digits b{};
+  if (small.exp < limit) {
+    low = limit;
+    sticky = true;
+    b = kernels::shift_right(small.mant,
+                             static_cast<std::size_t>(low - small.exp));
+  } else {
+    b = kernels::shift_left(small.mant,
+                            static_cast<std::size_t>(small.exp - low));
+  }
+  const auto a{
+      kernels::shift_left(big.mant, static_cast<std::size_t>(big.exp - low))};
+
+  Digits res{};
+  bool res_negative{big_negative};
+  if (big_negative == small_negative) {
+    // The sticky part can't carry into the kept bits.
+    res = kernels::add(a, b);
+  } else if (sticky) {
+    // a - b - (something in (0, 1)) truncates the same as a - b - 1.
+    res = kernels::sub(a, kernels::add(b, {1}));
+  } else if (kernels::compare(a, b) >= 0) {
+    res = kernels::sub(a, b);
+  } else {
+    res = kernels::sub(b, a);
+    res_negative = small_negative;
+  }
+
+  mant = std::move(res);
+  exp = low;
+  negative = res_negative;
+  bits = cap;
+  normalize();
+}
+
+} // namespace ln
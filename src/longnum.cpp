@@ -1,367 +1,518 @@
 #include "longnum.hpp"
 
 #include <algorithm>
-#include <ranges>
+#include <sstream>
+#include <string_view>
 
 namespace ln {
 
-Longnum::Longnum() : digits{}, precision{0}, negative{false} {}
+namespace {
 
-std::string Longnum::to_string(std::uint32_t fp_digits) const {
-  Longnum num{*this};
-  num.negative = false;
-  if (fp_digits) {
-    for (std::size_t i{0}; i < fp_digits; i++) {
-      num *= 10;
-    }
-  }
-  num.set_precision(0);
+using kernels::Digit;
+using kernels::Digits;
+using kernels::DoubleDigit;
 
-  std::string res;
-  while (num.sign() != 0) {
-    auto [q, r] = num.div_mod(10);
-    num = q;
-    res += static_cast<char>(r.get_digit(0) + '0');
+// Decimal digits are produced in chunks of `chunk_digits`, that is the
+// biggest power of 10 fitting into a single limb.
+constexpr auto chunk_digits{std::numeric_limits<Digit>::digits10};
 
-    if (res.size() == fp_digits) {
-      res += '.';
-    }
+constexpr Digit chunk_radix{[] {
+  Digit radix{1};
+  for (int i{0}; i < chunk_digits; i++) {
+    radix *= 10;
   }
+  return radix;
+}()};
 
-  while (res.size() < fp_digits) {
-    res += '0';
-    if (res.size() == fp_digits) {
-      res += '.';
-    }
-  }
+// Numbers that small are converted with repeated single-limb divisions.
+constexpr std::size_t leaf_limbs{32};
 
-  if (res.back() == '.' || res.empty()) {
-    res += '0';
-  }
+// Output is handed to the stream in blocks of about that many characters.
+constexpr std::size_t flush_size{1 << 16};
 
-  if (sign() < 0) {
-    res += '-';
+Digits pow10(std::uint32_t exp) {
+  Digits res{1};
+  Digits base{10};
+  while (exp != 0) {
+    if (exp & 1) {
+      res = kernels::mul(res, base);
+    }
+    exp >>= 1;
+    if (exp != 0) {
+      base = kernels::mul(base, base);
+    }
   }
-
-  std::reverse(res.begin(), res.end());
   return res;
 }
 
-std::size_t Longnum::bits_in_absolute_value() const {
-  return sign() == 0
-             ? 0
-             : digits.size() * digit_bits - std::countl_zero(digits.back());
-}
-
-Longnum::Precision Longnum::get_precision() const { return precision; }
+// Powers 10^(2^k * `chunk_digits`) used to split numbers in halves, computed
+// on demand.
+class DecimalPowers {
+public:
+  const Digits &operator()(std::size_t level) {
+    if (powers.empty()) {
+      powers.push_back({chunk_radix});
+    }
+    while (powers.size() <= level) {
+      powers.push_back(kernels::mul(powers.back(), powers.back()));
+    }
+    return powers[level];
+  }
+
+private:
+  std::vector<Digits> powers{};
+};
+
+// Divide-and-conquer radix conversion. A number is split by 10^(2^k * chunk)
+// into a high and a low half, which are written recursively, so digits come
+// out left to right and only leaves are ever turned into text.
+class DecimalWriter {
+public:
+  explicit DecimalWriter(std::ostream &os) : os{os} {}
+
+  // Writes `num` padded with leading zeros to `width` digits. If `width` is 0,
+  // no leading zeros are written.
+  void write(const Digits &num, std::size_t width) {
+    if (num.size() <= leaf_limbs) {
+      write_leaf(num, width);
+      return;
+    }
 
-Longnum &Longnum::set_precision(Longnum::Precision new_prec) {
-  auto old_prec{get_precision()};
-  if (new_prec == old_prec) {
-    return *this;
-  }
+    std::size_t level{0};
+    if (width == 0) {
+      while (kernels::compare(power(level + 1), num) <= 0) {
+        level++;
+      }
+    } else {
+      while ((static_cast<std::size_t>(chunk_digits) << (level + 1)) < width) {
+        level++;
+      }
+    }
 
-  if (new_prec > old_prec) {
-    *this <<= (new_prec - old_prec);
-  } else {
-    *this >>= (old_prec - new_prec);
+    const std::size_t low_width{static_cast<std::size_t>(chunk_digits)
+                                << level};
+    auto [hi, lo] = kernels::div_mod(num, power(level));
+    write(hi, width == 0 ? 0 : width - low_width);
+    write(lo, low_width);
   }
 
-  precision = new_prec;
-  remove_leading_zeros();
-  return *this;
-}
-
-int Longnum::sign() const {
-  if (digits.empty()) {
-    return 0;
+  void put(std::string_view str) {
+    buffer += str;
+    if (buffer.size() >= flush_size) {
+      flush();
+    }
   }
-  return negative ? -1 : 1;
-}
 
-Longnum &Longnum::flip_sign() {
-  if (sign() != 0) {
-    negative = !negative;
+  void flush() {
+    os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    buffer.clear();
   }
-  return *this;
-}
 
-std::strong_ordering Longnum::operator<=>(const Longnum &other) const {
-  auto this_sign{sign()};
-  auto other_sign{other.sign()};
+private:
+  std::ostream &os;
+  std::string buffer{};
 
-  if (this_sign != other_sign) {
-    return this_sign <=> other_sign;
-  }
+  DecimalPowers power{};
 
-  auto cmp{abs_compare(other)};
-  return this_sign >= 0 ? cmp : 0 <=> cmp;
-}
+  void write_leaf(Digits num, std::size_t width) {
+    std::string leaf{};
+    while (!num.empty()) {
+      auto chunk{kernels::div_small(num, chunk_radix)};
+      for (int i{0}; i < chunk_digits && (chunk != 0 || !num.empty()); i++) {
+        leaf += static_cast<char>('0' + chunk % 10);
+        chunk /= 10;
+      }
+    }
 
-std::strong_ordering Longnum::abs_compare(const Longnum &other) const {
-  auto this_bits{bits_in_absolute_value()};
-  auto other_bits{other.bits_in_absolute_value()};
+    if (leaf.empty() && width == 0) {
+      leaf += '0';
+    }
 
-  auto this_prec{get_precision()};
-  auto other_prec{other.get_precision()};
+    for (auto pad{width > leaf.size() ? width - leaf.size() : 0}; pad > 0;) {
+      const auto n{std::min(pad, flush_size)};
+      buffer.append(n, '0');
+      pad -= n;
+      if (buffer.size() >= flush_size) {
+        flush();
+      }
+    }
+    std::reverse(leaf.begin(), leaf.end());
+    put(leaf);
+  }
+};
+
+// Divide-and-conquer conversion from decimal, the reverse of `DecimalWriter`.
+// A string is split into a high part and a low part of 2^k * `chunk_digits`
+// digits, which are read recursively and joined as high * 10^(...) + low.
+class DecimalReader {
+public:
+  // Reads a non-empty string of decimal digits.
+  Digits read(std::string_view str) {
+    if (str.size() <= leaf_limbs * chunk_digits) {
+      return read_leaf(str);
+    }
 
-  auto this_msb{static_cast<std::intmax_t>(this_bits) - this_prec};
-  auto other_msb{static_cast<std::intmax_t>(other_bits) - other_prec};
-  if (this_msb != other_msb) {
-    return this_msb <=> other_msb;
-  }
+    std::size_t level{0};
+    while ((static_cast<std::size_t>(chunk_digits) << (level + 1)) <
+           str.size()) {
+      level++;
+    }
 
-  auto max_digit{std::max(max_digit_index(), other.max_digit_index())};
-  auto min_digit{std::min(min_digit_index(), other.min_digit_index())};
-  for (std::intmax_t i{max_digit}; i >= min_digit; i--) {
-    auto x{this->get_digit(i)};
-    auto y{other.get_digit(i)};
-    if (x != y) {
-      return x <=> y;
+    const std::size_t low_width{static_cast<std::size_t>(chunk_digits)
+                                << level};
+    const auto split{str.size() - low_width};
+    return kernels::add(kernels::mul(read(str.substr(0, split)), power(level)),
+                        read(str.substr(split)));
+  }
+
+private:
+  DecimalPowers power{};
+
+  static Digits read_leaf(std::string_view str) {
+    Digits res{};
+    while (!str.empty()) {
+      const auto n{std::min(str.size(),
+                            static_cast<std::size_t>(chunk_digits))};
+      Digit chunk{0};
+      Digit radix{1};
+      for (auto c : str.substr(0, n)) {
+        chunk = chunk * 10 + static_cast<Digit>(c - '0');
+        radix *= 10;
+      }
+      kernels::mul_small(res, radix, chunk);
+      str.remove_prefix(n);
     }
+    return res;
   }
+};
 
-  return std::strong_ordering::equal;
+bool all_digits(std::string_view str) {
+  return std::all_of(str.begin(), str.end(),
+                     [](char c) { return c >= '0' && c <= '9'; });
 }
 
-bool Longnum::operator==(const Longnum &other) const {
-  return (*this <=> other) == 0;
-}
+// Digits of bases up to 32, base32hex style.
+constexpr std::string_view radix_alphabet{"0123456789abcdefghijklmnopqrstuv"};
 
-bool Longnum::operator!=(const Longnum &other) const {
-  return !(*this == other);
+// Number of bits in a digit of `radix`.
+int radix_bits(Longnum::Radix radix) {
+  return std::countr_zero(static_cast<unsigned>(radix));
 }
 
-void Longnum::align_with(Longnum &other) {
-  const auto this_precision{get_precision()};
-  const auto other_precision{other.get_precision()};
-
-  if (this_precision < other_precision) {
-    this->set_precision(other_precision);
-  } else {
-    other.set_precision(this_precision);
+// Value of a digit in base32hex, or -1 if `c` is not a digit.
+int digit_value(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
   }
-}
-
-void Longnum::remove_leading_zeros() {
-  while (sign() != 0 && digits.back() == 0) {
-    digits.pop_back();
+  if (c >= 'a' && c <= 'v') {
+    return c - 'a' + 10;
   }
-  if (sign() == 0) {
-    negative = false;
+  if (c >= 'A' && c <= 'V') {
+    return c - 'A' + 10;
   }
+  return -1;
 }
 
-Longnum Longnum::operator<<(std::size_t sh) const {
-  Longnum x{*this};
-  return x <<= sh;
-}
-
-Longnum &Longnum::operator<<=(std::size_t sh) {
-  if (sign() == 0) {
-    return *this;
-  }
-
-  const auto full_digits{sh / digit_bits};
-
-  digits.insert(digits.begin(), full_digits, 0);
-
-  sh %= digit_bits;
-  if (sh == 0) {
-    return *this;
+// Returns `count` bits of `num` starting from bit `pos`, bits below 0 are
+// zeros. `count` must not exceed `digit_bits`.
+Digit bits_at(const Digits &num, std::intmax_t pos, int count) {
+  constexpr auto digit_bits{kernels::digit_bits};
+  const auto mask{static_cast<Digit>((DoubleDigit{1} << count) - 1)};
+  if (pos < 0) {
+    if (-pos >= count) {
+      return 0;
+    }
+    return static_cast<Digit>(bits_at(num, 0, count) << -pos) & mask;
   }
 
-  Digit carry{0};
-  for (auto &curr : digits) {
-    Digit shifted{static_cast<Digit>((curr << sh) | carry)};
-    carry = curr >> (digit_bits - sh);
-    curr = shifted;
+  const auto index{static_cast<std::size_t>(pos / digit_bits)};
+  DoubleDigit val{index < num.size() ? num[index] : Digit{0}};
+  if (index + 1 < num.size()) {
+    val |= static_cast<DoubleDigit>(num[index + 1]) << digit_bits;
   }
+  return static_cast<Digit>(val >> (pos % digit_bits)) & mask;
+}
 
-  if (carry != 0) {
-    digits.push_back(carry);
+// Appends the lowest `bytes` bytes of `value`, least significant first.
+void put_le(std::string &buf, std::uint64_t value, std::size_t bytes) {
+  for (std::size_t i{0}; i < bytes; i++) {
+    buf.push_back(static_cast<char>(value >> (8 * i)));
   }
-
-  remove_leading_zeros();
-  return *this;
 }
 
-Longnum Longnum::operator>>(std::size_t sh) const {
-  Longnum x{*this};
-  return x >>= sh;
+// Reads `bytes` bytes written by `put_le`.
+std::uint64_t get_le(const char *data, std::size_t bytes) {
+  std::uint64_t res{0};
+  for (std::size_t i{bytes}; i-- > 0;) {
+    res = (res << 8) | static_cast<unsigned char>(data[i]);
+  }
+  return res;
 }
 
-Longnum &Longnum::operator>>=(std::size_t sh) {
-  if (sign() == 0) {
-    return *this;
-  }
+} // namespace
 
-  const auto full_digits{sh / digit_bits};
-  if (full_digits >= digits.size()) {
-    return (*this = Longnum(0));
+Longnum Longnum::from_string(std::string_view str, Precision prec) {
+  if (prec < 0) {
+    throw std::invalid_argument("Precision must be non-negative");
   }
 
-  digits.erase(digits.begin(), digits.begin() + full_digits);
-
-  sh %= digit_bits;
-  if (sh == 0) {
-    return *this;
+  Longnum res{};
+  if (!str.empty() && (str[0] == '-' || str[0] == '+')) {
+    res.negative = str[0] == '-';
+    str.remove_prefix(1);
   }
 
-  Digit carry{0};
-  for (auto &curr : std::ranges::reverse_view(digits)) {
-    Digit shifted{static_cast<Digit>((curr >> sh) | carry)};
-    carry = curr << (digit_bits - sh);
-    curr = shifted;
+  const auto point{str.find('.')};
+  const auto int_part{str.substr(0, point)};
+  const auto frac_part{point == std::string_view::npos
+                           ? std::string_view{}
+                           : str.substr(point + 1)};
+  if (int_part.empty() || !all_digits(int_part) ||
+      (point != std::string_view::npos &&
+       (frac_part.empty() || !all_digits(frac_part)))) {
+    throw std::invalid_argument("Not a decimal number");
   }
 
-  remove_leading_zeros();
-  return *this;
-}
+  DecimalReader reader{};
+  res.digits = kernels::shift_left(reader.read(int_part),
+                                   static_cast<std::size_t>(prec));
+  res.precision = prec;
 
-Longnum::Digit Longnum::get_digit(std::intmax_t index) const {
-  if (get_precision() % digit_bits == 0) {
-    index += get_precision() / digit_bits;
-    return (index >= 0 && static_cast<std::size_t>(index) < digits.size())
-               ? digits[index]
-               : 0;
+  // The fraction is floor(frac * 2^`prec` / 10^(number of its digits)).
+  if (prec > 0 && !frac_part.empty()) {
+    const auto frac{kernels::shift_left(reader.read(frac_part),
+                                        static_cast<std::size_t>(prec))};
+    const auto scaled{kernels::div_mod(
+        frac, pow10(static_cast<std::uint32_t>(frac_part.size())))};
+    res.digits = kernels::add(res.digits, scaled.first);
   }
 
-  index = index * digit_bits + get_precision();
+  res.remove_leading_zeros();
+  return res;
+}
 
-  Digit lo{0};
-  if (index >= 0 &&
-      static_cast<std::size_t>(index / digit_bits) < digits.size()) {
-    lo = digits[index / digit_bits];
-  }
+Longnum Longnum::from_string(std::string_view str, Radix radix) {
+  const auto bits{radix_bits(radix)};
+  const auto base{static_cast<int>(radix)};
+
+  Longnum res{};
+  if (!str.empty() && (str[0] == '-' || str[0] == '+')) {
+    res.negative = str[0] == '-';
+    str.remove_prefix(1);
+  }
+
+  const auto point{str.find('.')};
+  const auto int_part{str.substr(0, point)};
+  const auto frac_part{point == std::string_view::npos
+                           ? std::string_view{}
+                           : str.substr(point + 1)};
+  if (int_part.empty() ||
+      (point != std::string_view::npos && frac_part.empty())) {
+    throw std::invalid_argument("Not a number in the given radix");
+  }
+  if (frac_part.size() * bits >
+      static_cast<std::size_t>(std::numeric_limits<Precision>::max())) {
+    throw std::invalid_argument("Fraction is too long");
+  }
+
+  // Digits are taken least significant first, the i'th one goes to bits
+  // [i * `bits`, (i + 1) * `bits`).
+  Digits digits((int_part.size() + frac_part.size()) * bits / digit_bits + 1,
+                0);
+  std::size_t pos{0};
+  auto put{[&](std::string_view part) {
+    for (auto it{part.rbegin()}; it != part.rend(); ++it) {
+      const auto value{digit_value(*it)};
+      if (value < 0 || value >= base) {
+        throw std::invalid_argument("Not a number in the given radix");
+      }
+
+      const auto val{static_cast<DoubleDigit>(value) << (pos % digit_bits)};
+      digits[pos / digit_bits] |= static_cast<Digit>(val);
+      if (const auto hi{static_cast<Digit>(val >> digit_bits)}; hi != 0) {
+        digits[pos / digit_bits + 1] |= hi;
+      }
+      pos += static_cast<std::size_t>(bits);
+    }
+  }};
+  put(frac_part);
+  put(int_part);
+
+  kernels::trim(digits);
+  res.digits = std::move(digits);
+  res.precision = static_cast<Precision>(frac_part.size() * bits);
+  res.remove_leading_zeros();
+  return res;
+}
 
-  index += digit_bits;
+std::string Longnum::to_string(std::uint32_t fp_digits) const {
+  std::ostringstream os;
+  write_decimal(os, fp_digits);
+  return std::move(os).str();
+}
 
-  Digit hi{0};
-  if (index >= 0 &&
-      static_cast<std::size_t>(index / digit_bits) < digits.size()) {
-    hi = digits[index / digit_bits];
+std::string Longnum::to_string(Radix radix) const {
+  const auto bits{radix_bits(radix)};
+
+  // The value is n * 2^(-`frac_len` * `bits`), n is `digits` * 2^`shift`.
+  const std::intmax_t frac_len{
+      get_precision() > 0 ? (get_precision() + bits - 1) / bits : 0};
+  const std::intmax_t shift{frac_len * bits - get_precision()};
+  // A zero has no bits to shift.
+  const auto total_bits{
+      sign() == 0
+          ? std::intmax_t{0}
+          : static_cast<std::intmax_t>(bits_in_absolute_value()) + shift};
+  const auto len{std::max((total_bits + bits - 1) / bits, frac_len + 1)};
+
+  std::string res{};
+  res.reserve(static_cast<std::size_t>(len + 2));
+  if (sign() < 0) {
+    res += '-';
   }
-
-  auto shift{(get_precision()) % digit_bits};
-  if (shift < 0) {
-    shift += digit_bits;
+  for (auto i{len}; i-- > 0;) {
+    if (i + 1 == frac_len) {
+      res += '.';
+    }
+    res += radix_alphabet[bits_at(digits, i * bits - shift, bits)];
   }
-
-  return (hi << (digit_bits - shift)) | (lo >> shift);
+  return res;
 }
 
-void Longnum::set_digit(std::intmax_t index, Digit digit, bool remove_zeros) {
-  if (get_precision() % digit_bits == 0) {
-    index += get_precision() / digit_bits;
-    if (index >= 0) {
-      digits.resize(
-          std::max(static_cast<std::size_t>(index + 1), digits.size()), 0);
-      digits[index] = digit;
-    }
-    return;
-  }
+void Longnum::write_decimal(std::ostream &os, std::uint32_t fp_digits) const {
+  DecimalWriter writer{os};
 
-  auto shift{(get_precision()) % digit_bits};
-  if (shift < 0) {
-    shift += digit_bits;
+  if (sign() < 0) {
+    writer.put("-");
   }
 
-  Digit lo{static_cast<Digit>(digit << shift)};
-  Digit hi{static_cast<Digit>(digit >> (digit_bits - shift))};
-
-  index = index * digit_bits + get_precision();
+  Longnum int_part{*this};
+  int_part.negative = false;
+  int_part.set_precision(0);
+  writer.write(int_part.digits, 0);
 
-  Digit mx{std::numeric_limits<Digit>::max()};
-
-  if (index >= 0) {
-    index /= digit_bits;
-    digits.resize(std::max(static_cast<std::size_t>(index + 2), digits.size()),
-                  0);
-
-    digits[index] = (digits[index] & (mx >> (digit_bits - shift))) | lo;
+  if (fp_digits == 0) {
+    writer.flush();
+    return;
+  }
 
-    index++;
+  writer.put(".");
 
-    digits[index] = (digits[index] & (mx << shift)) | hi;
-  } else if ((index += digit_bits) >= 0) {
-    index /= digit_bits;
-    digits.resize(std::max(static_cast<std::size_t>(index + 1), digits.size()),
-                  0);
+  // The fraction is floor(frac * 10^`fp_digits`), where frac is made of the
+  // lowest `precision` bits of `digits`.
+  Digits frac{};
+  if (get_precision() > 0) {
+    const auto full_limbs{
+        static_cast<std::size_t>(get_precision() / digit_bits)};
+    const auto rem_bits{get_precision() % digit_bits};
+    const auto frac_limbs{
+        std::min(digits.size(), full_limbs + (rem_bits != 0 ? 1 : 0))};
 
-    digits[index] = (digits[index] & (mx << shift)) | hi;
+    frac.assign(digits.begin(), digits.begin() + frac_limbs);
+    if (rem_bits != 0 && frac_limbs > full_limbs) {
+      frac.back() &=
+          static_cast<Digit>((static_cast<Digit>(1) << rem_bits) - 1);
+    }
+    kernels::trim(frac);
   }
 
-  if (remove_zeros) {
-    remove_leading_zeros();
-  }
+  Longnum scaled{};
+  scaled.digits = kernels::mul(frac, pow10(fp_digits));
+  scaled.precision = get_precision();
+  scaled.set_precision(0);
+  writer.write(scaled.digits, fp_digits);
+  writer.flush();
 }
 
-std::intmax_t Longnum::max_digit_index() const {
-  if (sign() == 0) {
-    return std::numeric_limits<std::intmax_t>::min();
-  }
-
-  std::intmax_t max_bit{static_cast<std::intmax_t>(bits_in_absolute_value()) -
-                        get_precision()};
-
-  if (max_bit >= 0 || max_bit % digit_bits == 0) {
-    return max_bit / digit_bits;
+void Longnum::write_binary(std::ostream &os) const {
+  const auto bytes{(bits_in_absolute_value() + 7) / 8};
+
+  // The magnitude goes out in blocks of `flush_size` bytes, so that no copy
+  // of the whole number is made.
+  std::string buf{};
+  buf.reserve(std::max(std::size_t{13}, std::min(bytes, flush_size)));
+  buf.push_back(static_cast<char>(negative ? 1 : 0));
+  put_le(buf, static_cast<std::uint32_t>(precision), 4);
+  put_le(buf, bytes, 8);
+  for (std::size_t i{0}; i < bytes; i++) {
+    if (buf.size() == flush_size) {
+      os.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+      buf.clear();
+    }
+    buf.push_back(static_cast<char>(digits[i / sizeof(Digit)] >>
+                                    (i % sizeof(Digit) * 8)));
   }
 
-  return max_bit / digit_bits - 1;
+  os.write(buf.data(), static_cast<std::streamsize>(buf.size()));
 }
 
-std::intmax_t Longnum::min_digit_index() const {
-  if (sign() == 0) {
-    return std::numeric_limits<std::intmax_t>::max();
-  }
-
-  std::intmax_t min_bit{-get_precision()};
+Longnum Longnum::read_binary(std::istream &is) {
+  std::array<char, 13> header{};
+  if (!is.read(header.data(), header.size()) ||
+      static_cast<unsigned char>(header[0]) > 1) {
+    throw std::invalid_argument("Malformed binary number");
+  }
+
+  // The size in the header is not trusted with an allocation: the magnitude
+  // is read in blocks of `flush_size` bytes, so truncated or corrupt data
+  // runs out before much memory is taken.
+  const auto bytes{get_le(header.data() + 5, 8)};
+  Digits digits{};
+  std::string buf{};
+  for (std::uint64_t done{0}; done < bytes;) {
+    const auto count{static_cast<std::size_t>(
+        std::min<std::uint64_t>(bytes - done, flush_size))};
+    buf.resize(count);
+    if (!is.read(buf.data(), static_cast<std::streamsize>(count))) {
+      throw std::invalid_argument("Malformed binary number");
+    }
 
-  if (min_bit >= 0 || min_bit % digit_bits == 0) {
-    return min_bit / digit_bits;
+    digits.resize((done + count + sizeof(Digit) - 1) / sizeof(Digit), 0);
+    for (std::size_t i{0}; i < count; i++) {
+      const auto pos{done + i};
+      digits[pos / sizeof(Digit)] |=
+          static_cast<Digit>(static_cast<unsigned char>(buf[i]))
+          << (pos % sizeof(Digit) * 8);
+    }
+    done += count;
   }
 
-  return min_bit / digit_bits - 1;
+  Longnum res{};
+  res.negative = header[0] == 1;
+  res.precision = static_cast<Precision>(
+      static_cast<std::uint32_t>(get_le(header.data() + 1, 4)));
+  res.digits = std::move(digits);
+  res.remove_leading_zeros();
+  return res;
 }
 
-bool Longnum::get_bit(std::intmax_t index) const {
-  const auto real_index{index + get_precision()};
-  if (real_index < 0 ||
-      static_cast<std::size_t>(real_index) / digit_bits >= digits.size()) {
-    return false;
+WorkingPrecision::WorkingPrecision(Longnum::Precision prec, Rounding rounding)
+    : precision{prec}, rounding{rounding}, previous{innermost} {
+  if (rounding == Rounding::nearest &&
+      prec == std::numeric_limits<Longnum::Precision>::max()) {
+    throw std::invalid_argument("Precision is out of range");
   }
-  return (digits[real_index / digit_bits] >> (real_index % digit_bits)) & 0x1;
+  innermost = this;
 }
 
-void Longnum::set_bit(std::intmax_t index, bool bit, bool remove_zeros) {
-  auto real_index{index + get_precision()};
+WorkingPrecision::~WorkingPrecision() { innermost = previous; }
 
-  if (real_index < 0) {
-    return;
-  }
+const WorkingPrecision *WorkingPrecision::current() { return innermost; }
 
-  const auto digits_needed{(real_index + digit_bits - 1) / digit_bits + 1};
-  digits.resize(
-      std::max(digits.size(), static_cast<std::size_t>(digits_needed)), 0);
+Longnum::Precision WorkingPrecision::get_precision() const {
+  return precision;
+}
 
-  Digit &val{digits[real_index / digit_bits]};
-  if (bit) {
-    val |= static_cast<Digit>(1) << (real_index % digit_bits);
-  } else {
-    val &= ~(static_cast<Digit>(1) << (real_index % digit_bits));
-  }
+Rounding WorkingPrecision::get_rounding() const { return rounding; }
 
-  if (remove_zeros) {
-    remove_leading_zeros();
-  }
+std::ostream &operator<<(std::ostream &os, const Longnum &num) {
+  num.write_decimal(os, static_cast<std::uint32_t>(os.precision()));
+  return os;
 }
 
 namespace lits {
 
 Longnum operator""_longnum(long double other) { return Longnum(other); }
-Longnum operator""_longnum(unsigned long long other) { return Longnum(other); }
 
 } // namespace lits
 
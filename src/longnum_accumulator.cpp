@@ -0,0 +1,174 @@
+#include "longnum_accumulator.hpp"
+
+#include <algorithm>
+
+namespace ln {
+
+namespace {
+
+using Digit = Accumulator::Digit;
+using DoubleDigit = Accumulator::DoubleDigit;
+
+constexpr auto digit_bits{Longnum::digit_bits};
+
+constexpr DoubleDigit digit_mask{(DoubleDigit{1} << digit_bits) - 1};
+
+// Every term adds less than 2^(`digit_bits` + 1) to a limb in absolute value,
+// so that many terms keep limbs below 2^62.
+constexpr std::uint64_t max_adds{std::uint64_t{1} << (61 - digit_bits)};
+
+} // namespace
+
+Accumulator::Accumulator(Precision prec)
+    : precision{prec}, adds_left{max_adds} {}
+
+Accumulator::Precision Accumulator::get_precision() const { return precision; }
+
+Accumulator &Accumulator::operator+=(const Longnum &x) {
+  add_scaled(x.digits, x.precision, x.negative);
+  return *this;
+}
+
+Accumulator &Accumulator::operator-=(const Longnum &x) {
+  add_scaled(x.digits, x.precision, !x.negative);
+  return *this;
+}
+
+Accumulator &Accumulator::add_product(const Longnum &a, const Longnum &b) {
+  if (a.sign() == 0 || b.sign() == 0) {
+    return *this;
+  }
+
+  add_scaled(kernels::mul(a.digits, b.digits),
+             static_cast<std::intmax_t>(a.precision) + b.precision,
+             a.negative != b.negative);
+  return *this;
+}
+
+Longnum Accumulator::value() const {
+  Accumulator acc{*this};
+  acc.normalize();
+
+  std::int64_t top{acc.limbs.empty() ? 0 : acc.limbs.back()};
+  if (!acc.limbs.empty()) {
+    acc.limbs.pop_back();
+  }
+
+  kernels::Digits low(acc.limbs.begin(), acc.limbs.end());
+  kernels::trim(low);
+
+  // The sum is `top` * 2^(n * `digit_bits`) + `low`, n being the size of
+  // `acc.limbs` now.
+  kernels::Digits high{};
+  for (auto rest{static_cast<std::uint64_t>(top < 0 ? -top : top)}; rest != 0;
+       rest >>= digit_bits) {
+    high.push_back(static_cast<Digit>(rest));
+  }
+  high = kernels::shift_left(high, acc.limbs.size() * digit_bits);
+
+  Longnum res{};
+  res.precision = precision;
+  if (top >= 0) {
+    res.digits = kernels::add(high, low);
+  } else {
+    res.digits = kernels::sub(high, low);
+    res.negative = true;
+  }
+  res.remove_leading_zeros();
+  return res;
+}
+
+void Accumulator::clear() {
+  limbs.clear();
+  adds_left = max_adds;
+}
+
+void Accumulator::add_scaled(const kernels::Digits &digits,
+                             std::intmax_t prec, bool negative) {
+  if (digits.empty()) {
+    return;
+  }
+
+  const auto sh{static_cast<std::intmax_t>(precision) - prec};
+  if (sh >= 0) {
+    add_shifted(digits, static_cast<std::size_t>(sh), negative);
+  } else {
+    add_shifted(kernels::shift_right(digits, static_cast<std::size_t>(-sh)), 0,
+                negative);
+  }
+}
+
+void Accumulator::add_shifted(const kernels::Digits &digits, std::size_t sh,
+                              bool negative) {
+  if (digits.empty()) {
+    return;
+  }
+
+  if (adds_left == 0) {
+    normalize();
+  }
+  adds_left--;
+
+  const auto offset{sh / digit_bits};
+  const auto bits{sh % digit_bits};
+
+  // One spare limb on top, so that the top one can take carries.
+  const auto needed{offset + digits.size() + 2};
+  if (limbs.size() < needed) {
+    limbs.resize(needed, 0);
+  }
+
+  const std::int64_t sign{negative ? -1 : 1};
+  auto *out{limbs.data() + offset};
+  for (std::size_t i{0}; i < digits.size(); i++) {
+    const auto val{static_cast<DoubleDigit>(digits[i]) << bits};
+    out[i] += sign * static_cast<std::int64_t>(val & digit_mask);
+    out[i + 1] += sign * static_cast<std::int64_t>(val >> digit_bits);
+  }
+}
+
+void Accumulator::normalize() {
+  std::int64_t carry{0};
+  for (std::size_t i{0}; i + 1 < limbs.size(); i++) {
+    const auto val{limbs[i] + carry};
+    limbs[i] = static_cast<std::int64_t>(static_cast<DoubleDigit>(val) &
+                                         digit_mask);
+    carry = val >> digit_bits;
+  }
+  if (!limbs.empty()) {
+    limbs.back() += carry;
+  }
+  adds_left = max_adds;
+}
+
+Longnum sum(std::span<const Longnum> values) {
+  Longnum::Precision prec{0};
+  for (const auto &x : values) {
+    prec = std::max(prec, x.get_precision());
+  }
+
+  Accumulator acc{prec};
+  for (const auto &x : values) {
+    acc += x;
+  }
+  return acc.value();
+}
+
+Longnum dot(std::span<const Longnum> a, std::span<const Longnum> b) {
+  if (a.size() != b.size()) {
+    throw std::invalid_argument("Vectors must have the same size");
+  }
+
+  Longnum::Precision prec{0};
+  for (std::size_t i{0}; i < a.size(); i++) {
+    prec = std::max(prec, a[i].get_precision() + b[i].get_precision());
+  }
+
+  Accumulator acc{prec};
+  for (std::size_t i{0}; i < a.size(); i++) {
+    acc.add_product(a[i], b[i]);
+  }
+  return acc.value();
+}
+
+} // namespace ln
@@ -0,0 +1,264 @@
+#include "longnum_array.hpp"
+
+#include <algorithm>
+
+namespace ln {
+
+namespace {
+
+using Digit = LongnumArray::Digit;
+using DoubleDigit = LongnumArray::DoubleDigit;
+
+constexpr auto digit_bits{Longnum::digit_bits};
+
+// Multiplication works on blocks of that many elements, so that the
+// temporaries of a block stay in cache.
+constexpr std::size_t block_size{64};
+
+// Writes the absolute value of elements [`first`, `first + n`) of a limb
+// plane array into `dst` and their signs into `neg`. The layout of `dst` is
+// the same as of the source, but with `n` elements. `carry` is a scratch
+// buffer of `n` digits.
+void load_abs(const std::vector<Digit> &src, std::size_t count,
+              std::size_t width, std::size_t first, std::size_t n, Digit *dst,
+              Digit *neg, Digit *carry) {
+  const auto *top{src.data() + (width - 1) * count + first};
+  for (std::size_t i{0}; i < n; i++) {
+    neg[i] = top[i] >> (digit_bits - 1);
+    carry[i] = neg[i];
+  }
+
+  // Conditional negation: (x ^ mask) + 1, where mask is all ones for negative
+  // numbers.
+  for (std::size_t k{0}; k < width; k++) {
+    const auto *row{src.data() + k * count + first};
+    auto *out{dst + k * n};
+    for (std::size_t i{0}; i < n; i++) {
+      const Digit mask{static_cast<Digit>(0 - neg[i])};
+      DoubleDigit val{static_cast<DoubleDigit>(row[i] ^ mask) + carry[i]};
+      out[i] = static_cast<Digit>(val);
+      carry[i] = static_cast<Digit>(val >> digit_bits);
+    }
+  }
+}
+
+} // namespace
+
+LongnumArray::LongnumArray(std::size_t size, std::size_t int_limbs,
+                           std::size_t frac_limbs)
+    : count{size}, int_limbs{int_limbs}, frac_limbs{frac_limbs} {
+  if (int_limbs + frac_limbs == 0) {
+    throw std::invalid_argument("Elements must have at least one limb");
+  }
+  limbs.assign(count * width(), 0);
+}
+
+LongnumArray::LongnumArray(std::span<const Longnum> values,
+                           std::size_t int_limbs, std::size_t frac_limbs)
+    : LongnumArray(values.size(), int_limbs, frac_limbs) {
+  for (std::size_t i{0}; i < values.size(); i++) {
+    set(i, values[i]);
+  }
+}
+
+std::size_t LongnumArray::size() const { return count; }
+
+std::size_t LongnumArray::width() const { return int_limbs + frac_limbs; }
+
+LongnumArray::Precision LongnumArray::get_precision() const {
+  return static_cast<Precision>(frac_limbs * digit_bits);
+}
+
+Longnum LongnumArray::get(std::size_t i) const {
+  Longnum res{};
+  auto &digits{res.digits.unshared()};
+  digits.resize(width());
+  for (std::size_t k{0}; k < width(); k++) {
+    digits[k] = limbs[k * count + i];
+  }
+
+  if (digits.back() >> (digit_bits - 1)) {
+    res.negative = true;
+    Digit carry{1};
+    for (auto &d : digits) {
+      DoubleDigit val{static_cast<DoubleDigit>(static_cast<Digit>(~d)) +
+                      carry};
+      d = static_cast<Digit>(val);
+      carry = static_cast<Digit>(val >> digit_bits);
+    }
+  }
+
+  res.precision = get_precision();
+  res.remove_leading_zeros();
+  return res;
+}
+
+void LongnumArray::set(std::size_t i, const Longnum &value) {
+  Longnum x{value};
+  x.set_precision(get_precision());
+
+  const Digit mask{static_cast<Digit>(x.negative ? ~Digit{0} : 0)};
+  Digit carry{static_cast<Digit>(x.negative ? 1 : 0)};
+  for (std::size_t k{0}; k < width(); k++) {
+    const Digit d{k < x.digits.size() ? x.digits[k] : Digit{0}};
+    DoubleDigit val{static_cast<DoubleDigit>(d ^ mask) + carry};
+    limbs[k * count + i] = static_cast<Digit>(val);
+    carry = static_cast<Digit>(val >> digit_bits);
+  }
+}
+
+std::vector<Longnum> LongnumArray::to_vector() const {
+  std::vector<Longnum> res{};
+  res.reserve(count);
+  for (std::size_t i{0}; i < count; i++) {
+    res.push_back(get(i));
+  }
+  return res;
+}
+
+LongnumArray LongnumArray::operator+(const LongnumArray &other) const {
+  LongnumArray x{*this};
+  return x += other;
+}
+
+LongnumArray &LongnumArray::operator+=(const LongnumArray &other) {
+  check_layout(other);
+
+  std::vector<Digit> carry(count, 0);
+  for (std::size_t k{0}; k < width(); k++) {
+    auto *row{limbs.data() + k * count};
+    const auto *other_row{other.limbs.data() + k * count};
+    for (std::size_t i{0}; i < count; i++) {
+      DoubleDigit val{static_cast<DoubleDigit>(row[i]) + other_row[i] +
+                      carry[i]};
+      row[i] = static_cast<Digit>(val);
+      carry[i] = static_cast<Digit>(val >> digit_bits);
+    }
+  }
+
+  return *this;
+}
+
+LongnumArray LongnumArray::operator-(const LongnumArray &other) const {
+  LongnumArray x{*this};
+  return x -= other;
+}
+
+LongnumArray &LongnumArray::operator-=(const LongnumArray &other) {
+  check_layout(other);
+
+  std::vector<Digit> borrow(count, 0);
+  for (std::size_t k{0}; k < width(); k++) {
+    auto *row{limbs.data() + k * count};
+    const auto *other_row{other.limbs.data() + k * count};
+    for (std::size_t i{0}; i < count; i++) {
+      DoubleDigit val{row[i]};
+      val -= other_row[i];
+      val -= borrow[i];
+      row[i] = static_cast<Digit>(val);
+      borrow[i] = (val >> digit_bits) ? 1 : 0;
+    }
+  }
+
+  return *this;
+}
+
+LongnumArray LongnumArray::operator*(const LongnumArray &other) const {
+  LongnumArray x{*this};
+  return x *= other;
+}
+
+LongnumArray &LongnumArray::operator*=(const LongnumArray &other) {
+  check_layout(other);
+
+  const auto w{width()};
+  std::vector<Digit> a(w * block_size);
+  std::vector<Digit> b(w * block_size);
+  std::vector<Digit> prod(2 * w * block_size);
+  std::vector<Digit> a_neg(block_size);
+  std::vector<Digit> b_neg(block_size);
+  std::vector<Digit> scratch(block_size);
+  std::vector<DoubleDigit> carry(block_size);
+
+  for (std::size_t first{0}; first < count; first += block_size) {
+    const auto n{std::min(block_size, count - first)};
+
+    load_abs(limbs, count, w, first, n, a.data(), a_neg.data(),
+             scratch.data());
+    load_abs(other.limbs, count, w, first, n, b.data(), b_neg.data(),
+             scratch.data());
+    std::fill(prod.begin(), prod.begin() + 2 * w * n, 0);
+
+    // Schoolbook multiplication of absolute values, element-wise.
+    for (std::size_t ka{0}; ka < w; ka++) {
+      std::fill(carry.begin(), carry.begin() + n, 0);
+      const auto *a_row{a.data() + ka * n};
+      for (std::size_t kb{0}; kb < w; kb++) {
+        const auto *b_row{b.data() + kb * n};
+        auto *p_row{prod.data() + (ka + kb) * n};
+        for (std::size_t i{0}; i < n; i++) {
+          DoubleDigit val{static_cast<DoubleDigit>(a_row[i]) * b_row[i] +
+                          p_row[i] + carry[i]};
+          p_row[i] = static_cast<Digit>(val);
+          carry[i] = val >> digit_bits;
+        }
+      }
+      auto *p_row{prod.data() + (ka + w) * n};
+      for (std::size_t i{0}; i < n; i++) {
+        p_row[i] = static_cast<Digit>(carry[i]);
+      }
+    }
+
+    // Drop extra fraction limbs and restore the sign.
+    for (std::size_t i{0}; i < n; i++) {
+      carry[i] = a_neg[i] ^ b_neg[i];
+    }
+    for (std::size_t k{0}; k < w; k++) {
+      const auto *p_row{prod.data() + (k + frac_limbs) * n};
+      auto *row{limbs.data() + k * count + first};
+      for (std::size_t i{0}; i < n; i++) {
+        const Digit mask{static_cast<Digit>(0 - (a_neg[i] ^ b_neg[i]))};
+        DoubleDigit val{static_cast<DoubleDigit>(p_row[i] ^ mask) + carry[i]};
+        row[i] = static_cast<Digit>(val);
+        carry[i] = val >> digit_bits;
+      }
+    }
+  }
+
+  return *this;
+}
+
+std::vector<int> LongnumArray::compare(const LongnumArray &other) const {
+  check_layout(other);
+
+  std::vector<int> res(count, 0);
+  if (count == 0) {
+    return res;
+  }
+
+  // The top limb holds the sign, flipping its high bit makes unsigned
+  // comparison work for it.
+  constexpr Digit sign_bit{static_cast<Digit>(Digit{1} << (digit_bits - 1))};
+  for (std::size_t k{width()}; k-- > 0;) {
+    const Digit flip{k == width() - 1 ? sign_bit : Digit{0}};
+    const auto *row{limbs.data() + k * count};
+    const auto *other_row{other.limbs.data() + k * count};
+    for (std::size_t i{0}; i < count; i++) {
+      const Digit x{static_cast<Digit>(row[i] ^ flip)};
+      const Digit y{static_cast<Digit>(other_row[i] ^ flip)};
+      const int cmp{(x > y) - (x < y)};
+      res[i] = res[i] != 0 ? res[i] : cmp;
+    }
+  }
+
+  return res;
+}
+
+void LongnumArray::check_layout(const LongnumArray &other) const {
+  if (count != other.count || int_limbs != other.int_limbs ||
+      frac_limbs != other.frac_limbs) {
+    throw std::invalid_argument("Arrays have different layouts");
+  }
+}
+
+} // namespace ln
@@ -0,0 +1,187 @@
+#include "longnum_async.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <memory>
+
+namespace ln {
+
+namespace {
+
+// log2(10), to estimate the size of decimal strings in limbs.
+constexpr double log2_10{3.3219280948873623};
+
+// Limbs needed for a number of `bits` bits.
+double limbs(double bits) { return bits / kernels::digit_bits + 1; }
+
+double limbs(const Longnum &x) {
+  return limbs(static_cast<double>(x.bits_in_absolute_value()));
+}
+
+// Checks for cancellation and turns reported work into progress calls.
+class Monitor final : public kernels::WorkMonitor {
+public:
+  Monitor(std::stop_token stop, const AsyncContext::Progress &progress,
+          double total)
+      : stop{std::move(stop)}, progress{progress}, total{total} {}
+
+  void report(std::size_t work) override {
+    if (stop.stop_requested()) {
+      throw Cancelled{};
+    }
+
+    done += static_cast<double>(work);
+    if (!progress) {
+      return;
+    }
+    const auto fraction{std::min(done / total, 1.0)};
+    if (fraction >= next) {
+      progress(fraction);
+      next = fraction + 0.01;
+    }
+  }
+
+private:
+  std::stop_token stop{};
+  const AsyncContext::Progress &progress;
+  double total{};
+  double done{};
+  double next{0.01};
+};
+
+// Installs a monitor for the current thread while alive.
+class MonitorScope {
+public:
+  explicit MonitorScope(kernels::WorkMonitor *monitor)
+      : previous{kernels::work_monitor} {
+    kernels::work_monitor = monitor;
+  }
+
+  ~MonitorScope() { kernels::work_monitor = previous; }
+
+  MonitorScope(const MonitorScope &other) = delete;
+  MonitorScope &operator=(const MonitorScope &other) = delete;
+
+private:
+  kernels::WorkMonitor *previous{};
+};
+
+} // namespace
+
+ThreadPool::~ThreadPool() {
+  for (auto &worker : workers) {
+    worker.request_stop();
+  }
+}
+
+ThreadPool::ThreadPool(std::size_t threads) {
+  if (threads == 0) {
+    throw std::invalid_argument("Thread pool needs at least one thread");
+  }
+
+  for (std::size_t i{0}; i < threads; i++) {
+    workers.emplace_back([this](std::stop_token stop) {
+      while (true) {
+        std::function<void()> task{};
+        {
+          std::unique_lock lock{mutex};
+          if (!cv.wait(lock, stop, [this] { return !tasks.empty(); })) {
+            return;
+          }
+          task = std::move(tasks.front());
+          tasks.pop_front();
+        }
+        task();
+      }
+    });
+  }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+  {
+    std::lock_guard lock{mutex};
+    tasks.push_back(std::move(task));
+  }
+  cv.notify_one();
+}
+
+AsyncContext::AsyncContext(Executor &executor) : executor{&executor} {}
+
+std::future<Longnum> AsyncContext::multiply(Longnum a, Longnum b,
+                                            std::stop_token stop,
+                                            Progress progress) const {
+  const auto total{limbs(a) * limbs(b)};
+  return run<Longnum>([a = std::move(a), b = std::move(b)] { return a * b; },
+                      total, std::move(stop), std::move(progress));
+}
+
+std::future<std::pair<Longnum, Longnum>>
+AsyncContext::div_mod(Longnum a, Longnum b, std::stop_token stop,
+                      Progress progress) const {
+  // Division, then multiplication by the quotient for the remainder.
+  const auto prec{std::max(a.get_precision(), b.get_precision())};
+  const auto quotient_bits{static_cast<double>(a.bits_in_absolute_value()) -
+                           a.get_precision() + prec + b.get_precision() -
+                           static_cast<double>(b.bits_in_absolute_value())};
+  const auto total{2 * limbs(std::max(quotient_bits, 0.0)) * limbs(b)};
+  return run<std::pair<Longnum, Longnum>>(
+      [a = std::move(a), b = std::move(b)] { return a.div_mod(b); }, total,
+      std::move(stop), std::move(progress));
+}
+
+std::future<std::string> AsyncContext::to_string(Longnum x,
+                                                 std::uint32_t fp_digits,
+                                                 std::stop_token stop,
+                                                 Progress progress) const {
+  // Splitting in halves costs about as much as a single division of the
+  // whole number by its square root, for the integer part and for the
+  // scaled fraction.
+  const auto int_limbs{limbs(static_cast<double>(x.bits_in_absolute_value()) -
+                             x.get_precision())};
+  const auto frac_limbs{limbs(fp_digits * log2_10 + x.get_precision())};
+  const auto total{int_limbs * int_limbs + frac_limbs * frac_limbs};
+  return run<std::string>(
+      [x = std::move(x), fp_digits] { return x.to_string(fp_digits); }, total,
+      std::move(stop), std::move(progress));
+}
+
+std::future<Longnum> AsyncContext::parse(std::string str,
+                                         Longnum::Precision prec,
+                                         std::stop_token stop,
+                                         Progress progress) const {
+  const auto n{limbs(static_cast<double>(str.size()) * log2_10 + prec)};
+  return run<Longnum>(
+      [str = std::move(str), prec] { return Longnum::from_string(str, prec); },
+      n * n, std::move(stop), std::move(progress));
+}
+
+template <class T>
+std::future<T> AsyncContext::run(std::function<T()> op, double total_work,
+                                 std::stop_token stop,
+                                 Progress progress) const {
+  auto promise{std::make_shared<std::promise<T>>()};
+  auto res{promise->get_future()};
+
+  executor->submit([promise, op = std::move(op), total_work,
+                    stop = std::move(stop), progress = std::move(progress)] {
+    try {
+      if (stop.stop_requested()) {
+        throw Cancelled{};
+      }
+
+      Monitor monitor{stop, progress, std::max(total_work, 1.0)};
+      MonitorScope scope{&monitor};
+      auto value{op()};
+      if (progress) {
+        progress(1.0);
+      }
+      promise->set_value(std::move(value));
+    } catch (...) {
+      promise->set_exception(std::current_exception());
+    }
+  });
+
+  return res;
+}
+
+} // namespace ln
@@ -0,0 +1,286 @@
+#include "longnum_ball.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace ln {
+
+namespace {
+
+constexpr auto mant_bits{std::numeric_limits<double>::digits};
+constexpr auto inf{std::numeric_limits<double>::infinity()};
+
+// Exponent differences are clamped to this when aligning two bounds. That
+// makes the smaller one bigger, so sums stay upper bounds and differences
+// stay lower bounds, and no double is ever denormal.
+constexpr std::int64_t min_exp_diff{-1000};
+
+// Returns `mant` * 2^(`exp` - `max_exp`), `exp` <= `max_exp`.
+double align(double mant, std::int64_t exp, std::int64_t max_exp) {
+  const auto diff{std::max(exp - max_exp, min_exp_diff)};
+  return std::ldexp(mant, static_cast<int>(diff));
+}
+
+// Rounding error of `x` + `y` = `sum` (TwoSum), the exact sum is `sum` plus
+// the returned value.
+double sum_error(double x, double y, double sum) {
+  const auto y_part{sum - x};
+  return (x - (sum - y_part)) + (y - y_part);
+}
+
+// Rounds `x` up if it is below the exact value, that is if `error` > 0.
+double round_up(double x, double error) {
+  return error > 0 ? std::nextafter(x, inf) : x;
+}
+
+} // namespace
+
+Ball::Bound Ball::Bound::above(const Longnum &x) {
+  auto res{below(x)};
+  if (x.bits_in_absolute_value() > mant_bits) {
+    // Some bits were cut off, ceil instead of floor. The mantissa is at most
+    // 2^`mant_bits` after that, still exact.
+    res.mant = std::ldexp(res.mant, mant_bits) + 1;
+    res.exp -= mant_bits;
+    res.normalize();
+  }
+  return res;
+}
+
+Ball::Bound Ball::Bound::below(const Longnum &x) {
+  if (x.sign() == 0) {
+    return {};
+  }
+
+  const auto bits{x.bits_in_absolute_value()};
+  const auto sh{bits > mant_bits ? bits - mant_bits : 0};
+  const auto top{kernels::shift_right(x.digits, sh)};
+
+  std::uint64_t mant{0};
+  for (auto digit : std::ranges::reverse_view(top)) {
+    mant = (mant << kernels::digit_bits) | digit;
+  }
+
+  Bound res{static_cast<double>(mant),
+            static_cast<std::int64_t>(sh) - x.get_precision()};
+  return res.normalize();
+}
+
+Ball::Bound Ball::Bound::power_of_two(std::int64_t exp) {
+  return {0.5, exp + 1};
+}
+
+Ball::Bound &Ball::Bound::normalize() {
+  if (mant == 0) {
+    exp = 0;
+    return *this;
+  }
+
+  int e{};
+  mant = std::frexp(mant, &e);
+  exp += e;
+  return *this;
+}
+
+Longnum Ball::Bound::to_longnum() const {
+  if (mant == 0) {
+    return {};
+  }
+
+  // `mant` * 2^`mant_bits` is an integer.
+  Longnum res(static_cast<std::uint64_t>(std::ldexp(mant, mant_bits)));
+  const auto sh{exp - mant_bits};
+  if (sh >= 0) {
+    return res <<= static_cast<std::size_t>(sh);
+  }
+  if (-sh > std::numeric_limits<Precision>::max()) {
+    throw std::invalid_argument("Radius is too small to be represented");
+  }
+  res.precision = static_cast<Precision>(-sh);
+  return res;
+}
+
+Ball::Bound Ball::Bound::add(const Bound &a, const Bound &b) {
+  if (a.mant == 0) {
+    return b;
+  }
+  if (b.mant == 0) {
+    return a;
+  }
+
+  const auto e{std::max(a.exp, b.exp)};
+  const auto x{align(a.mant, a.exp, e)};
+  const auto y{align(b.mant, b.exp, e)};
+  const auto sum{x + y};
+  Bound res{round_up(sum, sum_error(x, y, sum)), e};
+  return res.normalize();
+}
+
+Ball::Bound Ball::Bound::mul(const Bound &a, const Bound &b) {
+  if (a.mant == 0 || b.mant == 0) {
+    return {};
+  }
+
+  const auto prod{a.mant * b.mant};
+  const auto error{std::fma(a.mant, b.mant, -prod)};
+  Bound res{round_up(prod, error), a.exp + b.exp};
+  return res.normalize();
+}
+
+Ball::Bound Ball::Bound::div(const Bound &a, const Bound &b) {
+  if (a.mant == 0) {
+    return {};
+  }
+
+  // The quotient is too small if it times `b.mant` is less than `a.mant`.
+  const auto quot{a.mant / b.mant};
+  const auto error{std::fma(-quot, b.mant, a.mant)};
+  Bound res{round_up(quot, error), a.exp - b.exp};
+  return res.normalize();
+}
+
+Ball::Bound Ball::Bound::sub_down(const Bound &a, const Bound &b) {
+  if (b.mant == 0) {
+    return a;
+  }
+
+  const auto e{std::max(a.exp, b.exp)};
+  const auto x{align(a.mant, a.exp, e)};
+  const auto y{-align(b.mant, b.exp, e)};
+  auto diff{x + y};
+  if (sum_error(x, y, diff) < 0) {
+    diff = std::nextafter(diff, 0.0);
+  }
+  if (diff <= 0) {
+    return {};
+  }
+
+  Bound res{diff, e};
+  return res.normalize();
+}
+
+Ball::Ball(const Longnum &mid) : midpoint{mid} {}
+
+Ball::Ball(const Longnum &mid, const Longnum &rad)
+    : midpoint{mid}, radius{Bound::above(rad)} {}
+
+const Longnum &Ball::mid() const { return midpoint; }
+
+Longnum Ball::rad() const { return radius.to_longnum(); }
+
+Longnum Ball::lower() const {
+  WorkingPrecision::Suspend exact{};
+  return midpoint - rad();
+}
+
+Longnum Ball::upper() const {
+  WorkingPrecision::Suspend exact{};
+  return midpoint + rad();
+}
+
+Ball::Precision Ball::certified_precision() const {
+  constexpr auto max{std::numeric_limits<Precision>::max()};
+  constexpr auto min{std::numeric_limits<Precision>::min()};
+  if (radius.mant == 0) {
+    return max;
+  }
+
+  // The radius is below 2^`exp`, or exactly 2^(`exp` - 1).
+  const auto p{radius.mant == 0.5 ? 1 - radius.exp : -radius.exp};
+  return static_cast<Precision>(std::clamp<std::int64_t>(p, min, max));
+}
+
+bool Ball::contains(const Longnum &x) const {
+  return lower() <= x && x <= upper();
+}
+
+Ball Ball::operator-() const {
+  Ball res{*this};
+  res.midpoint = -res.midpoint;
+  return res;
+}
+
+Ball Ball::operator+(const Ball &other) const {
+  Ball res{*this};
+  return res += other;
+}
+
+Ball &Ball::operator+=(const Ball &other) {
+  // The radius accounts for no rounding but the one of `Longnum`.
+  WorkingPrecision::Suspend exact{};
+  midpoint += other.midpoint;
+  radius = Bound::add(radius, other.radius);
+  return *this;
+}
+
+Ball Ball::operator-(const Ball &other) const {
+  Ball res{*this};
+  return res -= other;
+}
+
+Ball &Ball::operator-=(const Ball &other) {
+  WorkingPrecision::Suspend exact{};
+  midpoint -= other.midpoint;
+  radius = Bound::add(radius, other.radius);
+  return *this;
+}
+
+Ball Ball::operator*(const Ball &other) const {
+  Ball res{*this};
+  return res *= other;
+}
+
+Ball &Ball::operator*=(const Ball &other) {
+  WorkingPrecision::Suspend exact{};
+
+  // |xy - ab| <= |a| rb + |b| ra + ra rb for |x - a| <= ra, |y - b| <= rb.
+  auto rad{Bound::add(
+      Bound::add(Bound::mul(Bound::above(midpoint), other.radius),
+                 Bound::mul(Bound::above(other.midpoint), radius)),
+      Bound::mul(radius, other.radius))};
+
+  // The product is truncated unless one of the operands is an integer.
+  const auto min_prec{
+      std::min(midpoint.get_precision(), other.midpoint.get_precision())};
+  const auto max_prec{
+      std::max(midpoint.get_precision(), other.midpoint.get_precision())};
+  if (min_prec > 0) {
+    rad = Bound::add(rad, Bound::power_of_two(-max_prec));
+  }
+
+  midpoint *= other.midpoint;
+  radius = rad;
+  return *this;
+}
+
+Ball Ball::operator/(const Ball &other) const {
+  Ball res{*this};
+  return res /= other;
+}
+
+Ball &Ball::operator/=(const Ball &other) {
+  // |x / y - a / b| <= (|b| ra + |a| rb) / (|b| |y|) for |x - a| <= ra,
+  // |y - b| <= rb, and |y| >= |b| - rb.
+  const auto b_low{Bound::below(other.midpoint)};
+  const auto y_low{Bound::sub_down(b_low, other.radius)};
+  if (y_low.mant == 0) {
+    throw std::invalid_argument("Divisor contains zero");
+  }
+
+  const auto num{
+      Bound::add(Bound::mul(Bound::above(other.midpoint), radius),
+                 Bound::mul(Bound::above(midpoint), other.radius))};
+  auto rad{Bound::div(Bound::div(num, b_low), y_low)};
+
+  const auto prec{
+      std::max(midpoint.get_precision(), other.midpoint.get_precision())};
+  rad = Bound::add(rad, Bound::power_of_two(-prec));
+
+  midpoint = ln::div(midpoint, other.midpoint, prec);
+  radius = rad;
+  return *this;
+}
+
+} // namespace ln
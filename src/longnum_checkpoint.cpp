@@ -0,0 +1,335 @@
+#include "longnum_checkpoint.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <streambuf>
+#include <system_error>
+#include <unordered_set>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace ln {
+
+namespace {
+
+constexpr std::string_view manifest_header{"longnum-checkpoint 1"};
+constexpr std::string_view manifest_name{"manifest"};
+constexpr std::string_view slot_prefix{"slot-"};
+
+struct Manifest {
+  std::uint64_t generation{};
+  std::uint64_t step{};
+  std::vector<std::string> files{};
+};
+
+std::optional<Manifest> read_manifest(const std::filesystem::path &dir) {
+  std::ifstream in(dir / manifest_name);
+  if (!in) {
+    return std::nullopt;
+  }
+
+  std::string header{};
+  std::getline(in, header);
+  Manifest res{};
+  std::size_t count{};
+  if (header != manifest_header ||
+      !(in >> res.generation >> res.step >> count)) {
+    throw std::invalid_argument("Malformed checkpoint manifest");
+  }
+
+  res.files.resize(count);
+  for (auto &file : res.files) {
+    if (!(in >> file)) {
+      throw std::invalid_argument("Malformed checkpoint manifest");
+    }
+  }
+  return res;
+}
+
+// Flushes a file, or a directory with `directory` set, to disk. Without it a
+// rename may survive a crash while the data it points to doesn't.
+void sync_to_disk(const std::filesystem::path &path,
+                  bool directory = false) {
+  const int fd{open(path.c_str(), directory ? O_RDONLY : O_WRONLY)};
+  if (fd == -1) {
+    throw std::system_error(errno, std::generic_category(),
+                            "Can't open " + path.string());
+  }
+  const int res{fsync(fd)};
+  const int err{errno};
+  close(fd);
+  if (res == -1) {
+    throw std::system_error(err, std::generic_category(),
+                            "Can't sync " + path.string());
+  }
+}
+
+[[noreturn]] void throw_errno(const std::string &what) {
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+// Output of `write_binary` into a file that already holds an older number.
+// It's compared with the file in blocks of `Checkpointer::block_size` bytes,
+// and only the blocks that differ are written.
+class BlockDiff : public std::streambuf {
+public:
+  BlockDiff(const BlockDiff &other) = delete;
+  BlockDiff &operator=(const BlockDiff &other) = delete;
+  ~BlockDiff() override { close(fd); }
+
+  // Opens `path`, it is created if missing.
+  explicit BlockDiff(std::filesystem::path path) : path{std::move(path)} {
+    fd = open(this->path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd == -1) {
+      throw_errno("Can't open " + this->path.string());
+    }
+    block.reserve(Checkpointer::block_size);
+  }
+
+  // Writes the last block, cuts off the rest of the older number and
+  // flushes the file to disk. Returns the number of blocks written.
+  std::uint64_t finish() {
+    write_block();
+    if (ftruncate(fd, static_cast<off_t>(offset)) == -1 || fsync(fd) == -1) {
+      throw_errno("Can't write " + path.string());
+    }
+    return written;
+  }
+
+protected:
+  std::streamsize xsputn(const char *s, std::streamsize n) override {
+    for (std::streamsize done{0}; done < n;) {
+      const auto count{std::min(
+          n - done,
+          static_cast<std::streamsize>(Checkpointer::block_size -
+                                       block.size()))};
+      block.append(s + done, static_cast<std::size_t>(count));
+      done += count;
+      if (block.size() == Checkpointer::block_size) {
+        write_block();
+      }
+    }
+    return n;
+  }
+
+  int_type overflow(int_type c) override {
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+      const auto ch{traits_type::to_char_type(c)};
+      xsputn(&ch, 1);
+    }
+    return traits_type::not_eof(c);
+  }
+
+private:
+  std::filesystem::path path{};
+  int fd{-1};
+  std::string block{};
+  std::string old{};
+  std::uint64_t offset{};
+  std::uint64_t written{};
+
+  // Writes `block` at `offset` unless the file has the same bytes there.
+  void write_block() {
+    old.resize(block.size());
+    std::size_t have{0};
+    while (have < old.size()) {
+      const auto res{pread(fd, old.data() + have, old.size() - have,
+                           static_cast<off_t>(offset + have))};
+      if (res == -1 && errno == EINTR) {
+        continue;
+      }
+      if (res == -1) {
+        throw_errno("Can't read " + path.string());
+      }
+      if (res == 0) {
+        break;
+      }
+      have += static_cast<std::size_t>(res);
+    }
+
+    if (have < block.size() || old != block) {
+      for (std::size_t done{0}; done < block.size();) {
+        const auto res{pwrite(fd, block.data() + done, block.size() - done,
+                              static_cast<off_t>(offset + done))};
+        if (res == -1 && errno == EINTR) {
+          continue;
+        }
+        if (res == -1) {
+          throw_errno("Can't write " + path.string());
+        }
+        done += static_cast<std::size_t>(res);
+      }
+      written++;
+    }
+
+    offset += block.size();
+    block.clear();
+  }
+};
+
+// Name of one of the two files of the slot `index`.
+std::string slot_file(std::size_t index, int turn) {
+  return std::string{slot_prefix} + std::to_string(index) + "-" +
+         std::to_string(turn) + ".bin";
+}
+
+bool same(const Longnum &a, const Longnum &b) {
+  return a.get_precision() == b.get_precision() && a == b;
+}
+
+} // namespace
+
+Checkpointer::~Checkpointer() {
+  {
+    std::lock_guard lock{mutex};
+    stopping = true;
+  }
+  cv.notify_all();
+  writer.join();
+}
+
+Checkpointer::Checkpointer(std::filesystem::path dir) : dir{std::move(dir)} {
+  std::filesystem::create_directories(this->dir);
+  if (auto manifest{read_manifest(this->dir)}) {
+    // Its files must not be written into until a newer snapshot is complete.
+    generation = manifest->generation + 1;
+    written_files = std::move(manifest->files);
+  }
+  writer = std::thread{[this] { run(); }};
+}
+
+std::optional<Checkpointer::Snapshot> Checkpointer::load() const {
+  auto manifest{read_manifest(dir)};
+  if (!manifest) {
+    return std::nullopt;
+  }
+
+  Snapshot res{manifest->step, {}};
+  for (const auto &file : manifest->files) {
+    std::ifstream in(dir / file, std::ios::binary);
+    if (!in) {
+      throw std::invalid_argument("Missing checkpoint file " + file);
+    }
+    res.state.push_back(Longnum::read_binary(in));
+  }
+  return res;
+}
+
+void Checkpointer::save(std::uint64_t step, std::span<const Longnum> state) {
+  Snapshot snapshot{step, {state.begin(), state.end()}};
+
+  {
+    std::lock_guard lock{mutex};
+    rethrow_error();
+    pending = std::move(snapshot);
+  }
+  cv.notify_all();
+}
+
+void Checkpointer::wait() {
+  std::unique_lock lock{mutex};
+  cv.wait(lock, [this] { return !pending && !busy; });
+  rethrow_error();
+}
+
+void Checkpointer::run() {
+  std::unique_lock lock{mutex};
+  while (true) {
+    cv.wait(lock, [this] { return pending || stopping; });
+    if (!pending) {
+      return;
+    }
+
+    auto snapshot{std::move(*pending)};
+    pending.reset();
+    busy = true;
+    lock.unlock();
+
+    std::exception_ptr failure{};
+    try {
+      write(std::move(snapshot));
+    } catch (...) {
+      failure = std::current_exception();
+    }
+
+    lock.lock();
+    busy = false;
+    if (failure) {
+      error = failure;
+    }
+    cv.notify_all();
+  }
+}
+
+void Checkpointer::write(Snapshot snapshot) {
+  const auto &state{snapshot.state};
+  std::vector<std::string> files(state.size());
+
+  for (std::size_t i{0}; i < state.size(); i++) {
+    if (i < written.state.size() && same(state[i], written.state[i])) {
+      files[i] = written_files[i];
+      continue;
+    }
+
+    // The file of the latest snapshot is kept intact, the other one gets
+    // the number.
+    const bool first_in_use{i < written_files.size() &&
+                            written_files[i] == slot_file(i, 0)};
+    files[i] = slot_file(i, first_in_use ? 1 : 0);
+    BlockDiff diff{dir / files[i]};
+    std::ostream out{&diff};
+    out.exceptions(std::ios::badbit);
+    state[i].write_binary(out);
+    written_blocks += diff.finish();
+  }
+
+  const auto tmp{dir / (std::string{manifest_name} + ".tmp")};
+  {
+    std::ofstream out(tmp, std::ios::trunc);
+    out << manifest_header << '\n'
+        << generation << '\n'
+        << snapshot.step << '\n'
+        << files.size() << '\n';
+    for (const auto &file : files) {
+      out << file << '\n';
+    }
+    out.close();
+    if (!out) {
+      throw std::runtime_error("Can't write checkpoint manifest");
+    }
+  }
+  sync_to_disk(tmp);
+  sync_to_disk(dir, true);
+  std::filesystem::rename(tmp, dir / manifest_name);
+  sync_to_disk(dir, true);
+
+  // Both files of every slot are kept, older ones are not needed anymore.
+  std::unordered_set<std::string> used{};
+  for (std::size_t i{0}; i < files.size(); i++) {
+    used.insert(slot_file(i, 0));
+    used.insert(slot_file(i, 1));
+  }
+  for (const auto &entry : std::filesystem::directory_iterator{dir}) {
+    const auto name{entry.path().filename().string()};
+    if (name.starts_with(slot_prefix) && !used.contains(name)) {
+      std::filesystem::remove(entry.path());
+    }
+  }
+
+  generation++;
+  written = std::move(snapshot);
+  written_files = std::move(files);
+}
+
+void Checkpointer::rethrow_error() {
+  if (error) {
+    std::rethrow_exception(std::exchange(error, nullptr));
+  }
+}
+
+} // namespace ln
@@ -0,0 +1,229 @@
+#include "longnum_gcd.hpp"
+
+#include <bit>
+#include <cstdint>
+
+namespace ln {
+
+namespace {
+
+using kernels::Digit;
+using kernels::Digits;
+
+constexpr auto digit_bits{kernels::digit_bits};
+
+// Sign-magnitude integer used for cofactors. Zero is never negative.
+struct Signed {
+  Digits mag{};
+  bool negative{};
+};
+
+Signed add(const Signed &x, const Signed &y) {
+  if (x.negative == y.negative) {
+    return {kernels::add(x.mag, y.mag), x.negative};
+  }
+  if (kernels::compare(x.mag, y.mag) >= 0) {
+    auto mag{kernels::sub(x.mag, y.mag)};
+    const bool negative{x.negative && !mag.empty()};
+    return {std::move(mag), negative};
+  }
+  return {kernels::sub(y.mag, x.mag), y.negative};
+}
+
+Signed mul(Signed x, std::intmax_t k) {
+  kernels::mul_small(x.mag, static_cast<Digit>(k < 0 ? -k : k));
+  x.negative = !x.mag.empty() && (x.negative != (k < 0));
+  return x;
+}
+
+Signed mul(const Signed &x, const Digits &q) {
+  auto mag{kernels::mul(x.mag, q)};
+  const bool negative{x.negative && !mag.empty()};
+  return {std::move(mag), negative};
+}
+
+// Cofactors of a Lehmer step: (u, v) becomes (a * u + b * v, c * u + d * v).
+// Signs of `a` and `b` are opposite unless one is 0, same for `c` and `d`.
+struct Cofactors {
+  std::intmax_t a{1};
+  std::intmax_t b{0};
+  std::intmax_t c{0};
+  std::intmax_t d{1};
+};
+
+// Returns x * `u` + y * `v`, where x and y have opposite signs (or one of them
+// is 0) and the result is known to be non-negative.
+Digits combine(const Digits &u, const Digits &v, std::intmax_t x,
+               std::intmax_t y) {
+  auto scaled_u{u};
+  auto scaled_v{v};
+  kernels::mul_small(scaled_u, static_cast<Digit>(x < 0 ? -x : x));
+  kernels::mul_small(scaled_v, static_cast<Digit>(y < 0 ? -y : y));
+  return y <= 0 ? kernels::sub(scaled_u, scaled_v)
+                : kernels::sub(scaled_v, scaled_u);
+}
+
+// Simulates Euclid's algorithm on the leading `digit_bits` bits of `u` >= `v`
+// (bits at the same positions are taken from both). Returns cofactors of the
+// steps that are guaranteed to match the real ones, `b` is 0 if there are
+// none.
+Cofactors lehmer_step(const Digits &u, const Digits &v) {
+  const auto n{u.size()};
+  const auto sh{std::countl_zero(u.back())};
+
+  auto top{[n, sh](const Digits &x) -> std::intmax_t {
+    const Digit hi{n - 1 < x.size() ? x[n - 1] : Digit{0}};
+    const Digit lo{n - 2 < x.size() ? x[n - 2] : Digit{0}};
+    if (sh == 0) {
+      return hi;
+    }
+    return static_cast<Digit>((hi << sh) | (lo >> (digit_bits - sh)));
+  }};
+
+  std::intmax_t uh{top(u)};
+  std::intmax_t vh{top(v)};
+
+  // Collins' condition: the quotient is the same for the smallest and largest
+  // values the leading bits may stand for.
+  Cofactors res{};
+  while (vh + res.c != 0 && vh + res.d != 0) {
+    const auto q{(uh + res.a) / (vh + res.c)};
+    if (q != (uh + res.b) / (vh + res.d)) {
+      break;
+    }
+
+    auto t{res.a - q * res.c};
+    res.a = res.c;
+    res.c = t;
+    t = res.b - q * res.d;
+    res.b = res.d;
+    res.d = t;
+    t = uh - q * vh;
+    uh = vh;
+    vh = t;
+  }
+
+  return res;
+}
+
+// Runs Lehmer's algorithm on `u` >= `v` and returns their gcd. If `su` and
+// `sv` are given, they are updated alongside `u` and `v`: if x * `su` = `u`
+// and x * `sv` = `v` modulo y initially, the same holds for the gcd and `su`
+// in the end.
+Digits lehmer_gcd(Digits u, Digits v, Signed *su, Signed *sv) {
+  while (v.size() >= 2) {
+    const auto step{lehmer_step(u, v)};
+
+    if (step.b == 0) {
+      // Leading bits tell nothing, take a full Euclid step.
+      auto [q, r] = kernels::div_mod(u, v);
+      u = std::move(v);
+      v = std::move(r);
+      if (su != nullptr) {
+        auto next{add(*su, mul(mul(*sv, q), -1))};
+        *su = std::move(*sv);
+        *sv = std::move(next);
+      }
+      continue;
+    }
+
+    auto new_u{combine(u, v, step.a, step.b)};
+    auto new_v{combine(u, v, step.c, step.d)};
+    u = std::move(new_u);
+    v = std::move(new_v);
+    if (su != nullptr) {
+      auto new_su{add(mul(*su, step.a), mul(*sv, step.b))};
+      auto new_sv{add(mul(*su, step.c), mul(*sv, step.d))};
+      *su = std::move(new_su);
+      *sv = std::move(new_sv);
+    }
+  }
+
+  while (!v.empty()) {
+    auto [q, r] = kernels::div_mod(u, v);
+    u = std::move(v);
+    v = std::move(r);
+    if (su != nullptr) {
+      auto next{add(*su, mul(mul(*sv, q), -1))};
+      *su = std::move(*sv);
+      *sv = std::move(next);
+    }
+  }
+
+  return u;
+}
+
+} // namespace
+
+Longnum gcd(const Longnum &a, const Longnum &b) {
+  Longnum x{a};
+  Longnum y{b};
+  x.set_precision(0);
+  y.set_precision(0);
+
+  if (kernels::compare(x.digits, y.digits) < 0) {
+    std::swap(x, y);
+  }
+
+  Longnum res{};
+  res.digits = lehmer_gcd(std::move(x.digits.unshared()),
+                          std::move(y.digits.unshared()), nullptr, nullptr);
+  return res;
+}
+
+XgcdResult xgcd(const Longnum &a, const Longnum &b) {
+  WorkingPrecision::Suspend exact{};
+  Longnum x{a};
+  Longnum y{b};
+  x.set_precision(0);
+  y.set_precision(0);
+
+  const bool swapped{kernels::compare(x.digits, y.digits) < 0};
+  if (swapped) {
+    std::swap(x, y);
+  }
+
+  // Cofactors of |x| only, the ones of |y| are found by exact division.
+  Signed su{{1}, false};
+  Signed sv{};
+  XgcdResult res{};
+  res.gcd.digits = lehmer_gcd(x.digits, y.digits, &su, &sv);
+
+  Longnum s{};
+  s.digits = std::move(su.mag);
+  s.negative = !s.digits.empty() && su.negative != x.negative;
+
+  Longnum t{};
+  if (y.sign() != 0) {
+    // x * s + y * t = gcd, so the division leaves no remainder.
+    t = (res.gcd - x * s).div_mod(y).first;
+  }
+
+  if (swapped) {
+    std::swap(s, t);
+  }
+  res.s = std::move(s);
+  res.t = std::move(t);
+  return res;
+}
+
+Longnum lcm(const Longnum &a, const Longnum &b) {
+  WorkingPrecision::Suspend exact{};
+  Longnum x{a};
+  Longnum y{b};
+  x.set_precision(0);
+  y.set_precision(0);
+
+  const auto g{gcd(x, y)};
+  if (g.sign() == 0) {
+    return g;
+  }
+
+  auto res{(x / g) * y};
+  if (res.sign() < 0) {
+    res = -res;
+  }
+  return res;
+}
+
+} // namespace ln
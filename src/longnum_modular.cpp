@@ -0,0 +1,184 @@
+#include "longnum_modular.hpp"
+
+#include <bit>
+#include <stdexcept>
+
+namespace ln {
+
+namespace {
+
+using kernels::Digit;
+using kernels::Digits;
+
+constexpr auto digit_bits{kernels::digit_bits};
+
+bool get_bit(const Digits &x, std::size_t index) {
+  return (x[index / digit_bits] >> (index % digit_bits)) & 1;
+}
+
+// Returns `x` / 2 modulo odd `m`, `x` must be less than `m`.
+Digits half_mod(const Digits &x, const Digits &m) {
+  if (!x.empty() && (x[0] & 1)) {
+    return kernels::shift_right(kernels::add(x, m), 1);
+  }
+  return kernels::shift_right(x, 1);
+}
+
+// Returns `x` - `y` modulo `m`, both must be less than `m`.
+Digits sub_mod(const Digits &x, const Digits &y, const Digits &m) {
+  if (kernels::compare(x, y) >= 0) {
+    return kernels::sub(x, y);
+  }
+  return kernels::sub(kernels::add(x, m), y);
+}
+
+} // namespace
+
+ModContext::ModContext(const Longnum &modulus) {
+  Longnum x{modulus};
+  x.set_precision(0);
+  if (x.sign() <= 0 || (x.digits[0] & 1) == 0 || x == 1) {
+    throw std::invalid_argument("Modulus must be odd and greater than 1");
+  }
+
+  m = x.digits;
+  m_inv = kernels::mont_inverse(m[0]);
+
+  const auto r_bits{m.size() * digit_bits};
+  one = kernels::div_mod(kernels::shift_left({1}, r_bits), m).second;
+  r2 = kernels::div_mod(kernels::shift_left({1}, 2 * r_bits), m).second;
+  one.resize(m.size(), 0);
+  r2.resize(m.size(), 0);
+}
+
+Longnum ModContext::modulus() const { return to_longnum(m); }
+
+Longnum ModContext::reduce(const Longnum &x) const {
+  return to_longnum(reduce_digits(x));
+}
+
+Longnum ModContext::mulmod(const Longnum &a, const Longnum &b) const {
+  // (a * b / R) * R^2 / R = a * b
+  auto prod{kernels::mont_mul(reduce_digits(a), reduce_digits(b), m, m_inv)};
+  return to_longnum(kernels::mont_mul(prod, r2, m, m_inv));
+}
+
+Longnum ModContext::powmod(const Longnum &base, const Longnum &exp) const {
+  Longnum e{exp};
+  e.set_precision(0);
+
+  auto x{e.sign() < 0 ? reduce_digits(inverse(base)) : reduce_digits(base)};
+  return to_longnum(from_mont(mont_pow(to_mont(x), e.digits)));
+}
+
+Longnum ModContext::inverse(const Longnum &a) const {
+  // Binary extended Euclidean algorithm. Invariants are
+  // `x1` * a = `u` and `x2` * a = `v` modulo `m`.
+  auto u{reduce_digits(a)};
+  kernels::trim(u);
+  Digits v{m};
+  Digits x1{1};
+  Digits x2{};
+
+  while (!u.empty()) {
+    while ((u[0] & 1) == 0) {
+      u = kernels::shift_right(u, 1);
+      x1 = half_mod(x1, m);
+    }
+    while ((v[0] & 1) == 0) {
+      v = kernels::shift_right(v, 1);
+      x2 = half_mod(x2, m);
+    }
+
+    if (kernels::compare(u, v) >= 0) {
+      u = kernels::sub(u, v);
+      x1 = sub_mod(x1, x2, m);
+    } else {
+      v = kernels::sub(v, u);
+      x2 = sub_mod(x2, x1, m);
+    }
+  }
+
+  if (v != Digits{1}) {
+    throw std::invalid_argument("The number has no modular inverse");
+  }
+
+  x2.resize(m.size(), 0);
+  return to_longnum(x2);
+}
+
+ModContext::Digits ModContext::reduce_digits(const Longnum &x) const {
+  Longnum y{x};
+  y.set_precision(0);
+
+  Digits res{y.digits};
+  if (kernels::compare(res, m) >= 0) {
+    res = kernels::div_mod(res, m).second;
+  }
+  if (y.negative && !res.empty()) {
+    res = kernels::sub(m, res);
+  }
+
+  res.resize(m.size(), 0);
+  return res;
+}
+
+Longnum ModContext::to_longnum(Digits x) {
+  Longnum res{};
+  res.digits = std::move(x);
+  res.remove_leading_zeros();
+  return res;
+}
+
+ModContext::Digits ModContext::to_mont(const Digits &x) const {
+  return kernels::mont_mul(x, r2, m, m_inv);
+}
+
+ModContext::Digits ModContext::from_mont(const Digits &x) const {
+  Digits unit(m.size(), 0);
+  unit[0] = 1;
+  return kernels::mont_mul(x, unit, m, m_inv);
+}
+
+ModContext::Digits ModContext::mont_pow(const Digits &x,
+                                        const Digits &exp) const {
+  if (exp.empty()) {
+    return one;
+  }
+
+  const auto bits{exp.size() * digit_bits - std::countl_zero(exp.back())};
+  const auto window{kernels::window_size(bits)};
+
+  // Odd powers x, x^3, ..., x^(2^`window` - 1).
+  std::vector<Digits> odd_powers{x};
+  const auto x2{kernels::mont_mul(x, x, m, m_inv)};
+  for (std::size_t i{1}; i < (std::size_t{1} << (window - 1)); i++) {
+    odd_powers.push_back(kernels::mont_mul(odd_powers.back(), x2, m, m_inv));
+  }
+
+  Digits res{one};
+  for (std::size_t i{bits}; i-- > 0;) {
+    if (!get_bit(exp, i)) {
+      res = kernels::mont_mul(res, res, m, m_inv);
+      continue;
+    }
+
+    // Take the longest window [j, i] that ends with a set bit.
+    std::size_t j{i + 1 > window ? i + 1 - window : 0};
+    while (!get_bit(exp, j)) {
+      j++;
+    }
+
+    std::size_t value{0};
+    for (std::size_t k{i + 1}; k-- > j;) {
+      value = (value << 1) | get_bit(exp, k);
+      res = kernels::mont_mul(res, res, m, m_inv);
+    }
+    res = kernels::mont_mul(res, odd_powers[value >> 1], m, m_inv);
+    i = j;
+  }
+
+  return res;
+}
+
+} // namespace ln
@@ -0,0 +1,200 @@
+#include "longnum_real.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+namespace ln {
+
+struct Real::Node {
+  virtual ~Node() = default;
+
+  // Returns an approximation with an error of at most 2^(-`prec`).
+  virtual Longnum compute(Precision prec) const = 0;
+
+  // The best approximation so far and its error bound.
+  Longnum cached{};
+  Precision cached_precision{-1};
+
+  struct Exact;
+  struct Approximated;
+  struct Negation;
+  struct Sum;
+  struct Product;
+  struct Quotient;
+};
+
+namespace {
+
+using Precision = Real::Precision;
+
+// Checks that a precision derived from a requested one still fits.
+Precision to_precision(std::intmax_t prec) {
+  if (prec > std::numeric_limits<Precision>::max()) {
+    throw std::invalid_argument("Required precision is too big");
+  }
+  return static_cast<Precision>(std::max<std::intmax_t>(prec, 0));
+}
+
+// Returns m such that |`x`| < 2^m.
+std::intmax_t magnitude(const Longnum &x) {
+  return static_cast<std::intmax_t>(x.bits_in_absolute_value()) -
+         x.get_precision();
+}
+
+// Returns m such that both the number `x` approximates with an error of at
+// most 1, and `x` itself are less than 2^m by absolute value.
+std::intmax_t upper_bound(const Longnum &x) {
+  return std::max<std::intmax_t>(magnitude(x), 0) + 2;
+}
+
+} // namespace
+
+struct Real::Node::Exact final : Node {
+  Longnum value{};
+
+  explicit Exact(Longnum value) : value{std::move(value)} {}
+
+  Longnum compute(Precision) const override { return value; }
+};
+
+struct Real::Node::Approximated final : Node {
+  Real::Generator generator{};
+
+  explicit Approximated(Real::Generator generator)
+      : generator{std::move(generator)} {}
+
+  Longnum compute(Precision prec) const override { return generator(prec); }
+};
+
+struct Real::Node::Negation final : Node {
+  Real x{};
+
+  explicit Negation(Real x) : x{std::move(x)} {}
+
+  Longnum compute(Precision prec) const override { return -x.approx(prec); }
+};
+
+struct Real::Node::Sum final : Node {
+  Real a{};
+  Real b{};
+  bool subtract{};
+
+  Sum(Real a, Real b, bool subtract)
+      : a{std::move(a)}, b{std::move(b)}, subtract{subtract} {}
+
+  Longnum compute(Precision prec) const override {
+    // Errors of the operands add up, the sum itself is exact.
+    const auto p{to_precision(std::intmax_t{prec} + 1)};
+    return subtract ? a.approx(p) - b.approx(p) : a.approx(p) + b.approx(p);
+  }
+};
+
+struct Real::Node::Product final : Node {
+  Real a{};
+  Real b{};
+
+  Product(Real a, Real b) : a{std::move(a)}, b{std::move(b)} {}
+
+  Longnum compute(Precision prec) const override {
+    // |x'y' - xy| <= |x'| |y' - y| + |y| |x' - x|, so the error of each
+    // operand is scaled by the magnitude of the other one. Both terms and
+    // the truncation of the product are at most 2^(-`prec` - 2).
+    const auto ma{upper_bound(a.approx(0))};
+    const auto mb{upper_bound(b.approx(0))};
+    const auto x{a.approx(to_precision(std::intmax_t{prec} + 2 + mb))};
+    const auto y{b.approx(to_precision(std::intmax_t{prec} + 2 + ma))};
+    return x * y;
+  }
+};
+
+struct Real::Node::Quotient final : Node {
+  Real a{};
+  Real b{};
+
+  // L such that |b| >= 2^L, found once.
+  mutable std::optional<std::intmax_t> lower{};
+
+  Quotient(Real a, Real b) : a{std::move(a)}, b{std::move(b)} {}
+
+  std::intmax_t lower_bound() const {
+    if (lower) {
+      return *lower;
+    }
+
+    for (Precision k{4}; k <= Real::max_divisor_precision; k *= 2) {
+      // If |y'| >= 2^(t - 1) >= 4 * 2^(-k), then |y| >= 2^(t - 2).
+      const auto t{magnitude(b.approx(k))};
+      if (t >= 3 - k) {
+        lower = t - 2;
+        return *lower;
+      }
+    }
+    throw std::invalid_argument("Division by zero or a number too close to it");
+  }
+
+  Longnum compute(Precision prec) const override {
+    // |x'/y' - x/y| <= |x' - x| / |y'| + |x| |y' - y| / (|y| |y'|), and
+    // |y'| >= 2^(L - 1) once |y' - y| <= 2^(L - 1). Both terms and the
+    // truncation of the quotient are at most 2^(-`prec` - 2).
+    const auto l{lower_bound()};
+    const auto ma{upper_bound(a.approx(0))};
+    const auto pa{std::intmax_t{prec} + 3 - l};
+    const auto pb{std::max(std::intmax_t{prec} + 3 + ma - 2 * l, 1 - l)};
+
+    const auto x{a.approx(to_precision(pa))};
+    const auto y{b.approx(to_precision(pb))};
+    return div(x, y, to_precision(std::intmax_t{prec} + 2));
+  }
+};
+
+Real::Real() : Real(Longnum{}) {}
+
+Real::Real(const Longnum &value) : node{std::make_shared<Node::Exact>(value)} {}
+
+Real::Real(Generator generator)
+    : node{std::make_shared<Node::Approximated>(std::move(generator))} {}
+
+Real::Real(std::shared_ptr<Node> node) : node{std::move(node)} {}
+
+Longnum Real::approx(Precision prec) const {
+  if (prec < 0) {
+    throw std::invalid_argument("Precision must be non-negative");
+  }
+
+  // The error bounds of the nodes rely on exact sums and products.
+  WorkingPrecision::Suspend exact{};
+  if (node->cached_precision < prec) {
+    auto value{node->compute(prec)};
+    if (value.get_precision() < prec) {
+      value.set_precision(prec);
+    }
+    node->cached = std::move(value);
+    node->cached_precision = prec;
+  }
+  return node->cached;
+}
+
+Real Real::operator-() const {
+  return Real(std::make_shared<Node::Negation>(*this));
+}
+
+Real operator+(const Real &a, const Real &b) {
+  return Real(std::make_shared<Real::Node::Sum>(a, b, false));
+}
+
+Real operator-(const Real &a, const Real &b) {
+  return Real(std::make_shared<Real::Node::Sum>(a, b, true));
+}
+
+Real operator*(const Real &a, const Real &b) {
+  return Real(std::make_shared<Real::Node::Product>(a, b));
+}
+
+Real operator/(const Real &a, const Real &b) {
+  return Real(std::make_shared<Real::Node::Quotient>(a, b));
+}
+
+} // namespace ln
@@ -0,0 +1,694 @@
+#include "mapped_longnum.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace ln {
+
+namespace {
+
+using kernels::Digits;
+using Digit = MappedLongnum::Digit;
+
+// Data goes between streams and limbs in blocks of that many bytes.
+constexpr std::size_t io_block{std::size_t{1} << 16};
+
+// Bytes in the header of the `Longnum::write_binary` format: sign, precision
+// and the number of bytes of the absolute value.
+constexpr std::size_t header_size{13};
+
+[[noreturn]] void throw_errno(const char *what) {
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+// Appends `bytes` least significant bytes of `value` to `buf`.
+void put_le(std::string &buf, std::uint64_t value, std::size_t bytes) {
+  for (std::size_t i{0}; i < bytes; i++) {
+    buf.push_back(static_cast<char>(value >> (8 * i)));
+  }
+}
+
+// Reads `bytes` bytes written by `put_le`.
+std::uint64_t get_le(const char *data, std::size_t bytes) {
+  std::uint64_t res{0};
+  for (std::size_t i{bytes}; i-- > 0;) {
+    res = (res << 8) | static_cast<unsigned char>(data[i]);
+  }
+  return res;
+}
+
+// A number shifted left by `offset` limbs and `bits` bits, read limb by limb.
+struct Shifted {
+  std::span<const Digit> limbs{};
+  std::size_t offset{};
+  int bits{};
+
+  std::size_t size() const {
+    return limbs.empty() ? 0 : limbs.size() + offset + (bits != 0 ? 1 : 0);
+  }
+
+  Digit operator[](std::size_t i) const {
+    if (i < offset) {
+      return 0;
+    }
+    const auto j{i - offset};
+    Digit res{j < limbs.size() ? static_cast<Digit>(limbs[j] << bits) : 0};
+    if (bits != 0 && j >= 1 && j - 1 < limbs.size()) {
+      res |= static_cast<Digit>(limbs[j - 1] >> (kernels::digit_bits - bits));
+    }
+    return res;
+  }
+};
+
+// Arithmetic modulo the prime p = 2^64 - 2^32 + 1. As 2^64 = 2^32 - 1 and
+// 2^96 = -1 modulo p, products are reduced with a few additions, and since
+// 2^32 divides p - 1, there are roots of unity of orders up to 2^32.
+namespace field {
+
+constexpr std::uint64_t modulus{0xffff'ffff'0000'0001};
+
+// 2^64 modulo p.
+constexpr std::uint64_t epsilon{0xffff'ffff};
+
+// Generator of the multiplicative group.
+constexpr std::uint64_t generator{7};
+
+constexpr int max_log_order{32};
+
+std::uint64_t add(std::uint64_t a, std::uint64_t b) {
+  auto res{a + b};
+  if (res < a) {
+    // The sum is below 2p, so adding back 2^64 - p fits.
+    return res + epsilon;
+  }
+  return res >= modulus ? res - modulus : res;
+}
+
+std::uint64_t sub(std::uint64_t a, std::uint64_t b) {
+  return a >= b ? a - b : a + (modulus - b);
+}
+
+std::uint64_t mul(std::uint64_t a, std::uint64_t b) {
+  const auto a0{a & epsilon};
+  const auto a1{a >> 32};
+  const auto b0{b & epsilon};
+  const auto b1{b >> 32};
+  const auto p00{a0 * b0};
+  const auto p01{a0 * b1};
+  const auto p10{a1 * b0};
+  const auto mid{(p00 >> 32) + (p01 & epsilon) + (p10 & epsilon)};
+  const auto lo{(mid << 32) | (p00 & epsilon)};
+  const auto hi{a1 * b1 + (p01 >> 32) + (p10 >> 32) + (mid >> 32)};
+
+  // lo + 2^64 * hi = lo + (2^32 - 1) * (hi mod 2^32) - (hi / 2^32).
+  auto res{lo - (hi >> 32)};
+  if (lo < (hi >> 32)) {
+    res -= epsilon;
+  }
+  const auto term{(hi & epsilon) * epsilon};
+  res += term;
+  if (res < term) {
+    res += epsilon;
+  }
+  return res >= modulus ? res - modulus : res;
+}
+
+std::uint64_t pow(std::uint64_t base, std::uint64_t exp) {
+  std::uint64_t res{1};
+  for (; exp != 0; exp >>= 1) {
+    if (exp & 1) {
+      res = mul(res, base);
+    }
+    base = mul(base, base);
+  }
+  return res;
+}
+
+std::uint64_t inverse(std::uint64_t x) { return pow(x, modulus - 2); }
+
+// A root of unity of order 2^`log_order`.
+std::uint64_t root(int log_order) {
+  return pow(generator, (modulus - 1) >> log_order);
+}
+
+} // namespace field
+
+// Powers of a root of unity, and of its inverse, that transforms of
+// 2^`log_size` points take.
+struct Roots {
+  std::vector<std::uint64_t> forward{};
+  std::vector<std::uint64_t> inverse{};
+
+  explicit Roots(int log_size) {
+    const std::size_t half{(std::size_t{1} << log_size) / 2};
+    const auto w{field::root(log_size)};
+    const auto iw{field::inverse(w)};
+    forward.resize(half);
+    inverse.resize(half);
+    std::uint64_t x{1};
+    std::uint64_t ix{1};
+    for (std::size_t j{0}; j < half; j++) {
+      forward[j] = x;
+      inverse[j] = ix;
+      x = field::mul(x, w);
+      ix = field::mul(ix, iw);
+    }
+  }
+};
+
+// Transform of `size` points in place, natural order in and bit-reversed
+// order out.
+void forward_transform(std::uint64_t *a, std::size_t size,
+                       const Roots &roots) {
+  for (std::size_t len{size}; len >= 2; len /= 2) {
+    const auto half{len / 2};
+    const auto step{size / len};
+    for (std::size_t first{0}; first < size; first += len) {
+      for (std::size_t j{0}; j < half; j++) {
+        const auto u{a[first + j]};
+        const auto v{a[first + j + half]};
+        a[first + j] = field::add(u, v);
+        a[first + j + half] =
+            field::mul(field::sub(u, v), roots.forward[j * step]);
+      }
+    }
+  }
+}
+
+// Inverse of `forward_transform`, except that the result is `size` times
+// bigger: bit-reversed order in and natural order out.
+void inverse_transform(std::uint64_t *a, std::size_t size,
+                       const Roots &roots) {
+  for (std::size_t len{2}; len <= size; len *= 2) {
+    const auto half{len / 2};
+    const auto step{size / len};
+    for (std::size_t first{0}; first < size; first += len) {
+      for (std::size_t j{0}; j < half; j++) {
+        const auto u{a[first + j]};
+        const auto v{field::mul(a[first + j + half], roots.inverse[j * step])};
+        a[first + j] = field::add(u, v);
+        a[first + j + half] = field::sub(u, v);
+      }
+    }
+  }
+}
+
+std::size_t reverse_bits(std::size_t x, int bits) {
+  std::size_t res{0};
+  for (int i{0}; i < bits; i++) {
+    res = (res << 1) | ((x >> i) & 1);
+  }
+  return res;
+}
+
+// Transform values in an unlinked scratch file mapped into memory.
+class Scratch {
+public:
+  Scratch(const std::filesystem::path &dir, std::size_t size) : size{size} {
+    auto name{(dir / "longnum-XXXXXX").string()};
+    fd = mkstemp(name.data());
+    if (fd == -1) {
+      throw_errno("Can't create a scratch file");
+    }
+    unlink(name.c_str());
+
+    const auto bytes{size * sizeof(std::uint64_t)};
+    if (ftruncate(fd, static_cast<off_t>(bytes)) == -1) {
+      close(fd);
+      throw_errno("Can't resize a scratch file");
+    }
+    auto ptr{mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)};
+    if (ptr == MAP_FAILED) {
+      close(fd);
+      throw_errno("Can't map a scratch file");
+    }
+    data = static_cast<std::uint64_t *>(ptr);
+  }
+
+  ~Scratch() {
+    munmap(data, size * sizeof(std::uint64_t));
+    close(fd);
+  }
+
+  Scratch(const Scratch &other) = delete;
+  Scratch &operator=(const Scratch &other) = delete;
+
+  std::uint64_t &operator[](std::size_t i) { return data[i]; }
+
+  std::uint64_t *row(std::size_t first) { return data + first; }
+
+private:
+  int fd{-1};
+  std::uint64_t *data{nullptr};
+  std::size_t size{};
+};
+
+// A transform of 2^`log_size` points done as in Bailey's four-step
+// algorithm: the points are a matrix of `rows` x `cols` kept in row-major
+// order, with point n = `cols` * n1 + n2 in row n1 and column n2.
+//
+// Forward, every column is transformed, entry (k1, n2) is multiplied by
+// w^(n2 * k1), where w is the root of order 2^`log_size`, and then every
+// row is transformed. Sub-transforms leave their results in bit-reversed
+// order, so k1 is the reversed row index, and pointwise products don't care
+// about the order. The inverse undoes those steps backwards.
+struct FourStep {
+  int log_size{};
+  int log_rows{};
+  std::size_t rows{};
+  std::size_t cols{};
+  Roots column_roots;
+  Roots row_roots;
+  std::uint64_t root{};
+  std::uint64_t inverse_root{};
+  std::uint64_t inverse_size{};
+
+  explicit FourStep(int log_size)
+      : log_size{log_size}, log_rows{log_size / 2},
+        rows{std::size_t{1} << log_rows},
+        cols{std::size_t{1} << (log_size - log_rows)}, column_roots{log_rows},
+        row_roots{log_size - log_rows}, root{field::root(log_size)},
+        inverse_root{field::inverse(root)},
+        inverse_size{field::inverse(std::uint64_t{1} << log_size)} {}
+
+  // Transforms the columns of `out`, `batch` of them at a time gathered in
+  // memory. `load(n)` gives the value of point n before the transform, and
+  // `inverse` selects the direction.
+  template <typename Load>
+  void columns(Scratch &out, std::size_t batch, bool inverse,
+               Load load) const {
+    batch = std::clamp(batch, std::size_t{1}, cols);
+    std::vector<std::uint64_t> buf(batch * rows);
+    for (std::size_t first{0}; first < cols; first += batch) {
+      const auto count{std::min(batch, cols - first)};
+      for (std::size_t r{0}; r < rows; r++) {
+        for (std::size_t j{0}; j < count; j++) {
+          buf[j * rows + r] = load(r * cols + first + j);
+        }
+      }
+      for (std::size_t j{0}; j < count; j++) {
+        if (inverse) {
+          inverse_transform(buf.data() + j * rows, rows, column_roots);
+        } else {
+          forward_transform(buf.data() + j * rows, rows, column_roots);
+        }
+      }
+      for (std::size_t r{0}; r < rows; r++) {
+        for (std::size_t j{0}; j < count; j++) {
+          out[r * cols + first + j] = buf[j * rows + r];
+        }
+      }
+    }
+  }
+
+  // Multiplies row `r` by the twiddle factors, starting with `scale`.
+  void twiddle(std::uint64_t *row, std::size_t r, bool inverse,
+               std::uint64_t scale) const {
+    const auto base{field::pow(inverse ? inverse_root : root,
+                               reverse_bits(r, log_rows))};
+    for (std::size_t n{0}; n < cols; n++) {
+      row[n] = field::mul(row[n], scale);
+      scale = field::mul(scale, base);
+    }
+  }
+};
+
+} // namespace
+
+MappedLongnum::~MappedLongnum() { release(); }
+
+MappedLongnum::MappedLongnum(MappedLongnum &&other) noexcept
+    : fd{other.fd}, data{other.data}, length{other.length},
+      precision{other.precision}, negative{other.negative} {
+  other.fd = -1;
+  other.data = nullptr;
+  other.length = 0;
+}
+
+MappedLongnum &MappedLongnum::operator=(MappedLongnum &&other) noexcept {
+  if (this != &other) {
+    release();
+    fd = std::exchange(other.fd, -1);
+    data = std::exchange(other.data, nullptr);
+    length = std::exchange(other.length, 0);
+    precision = other.precision;
+    negative = other.negative;
+  }
+  return *this;
+}
+
+MappedLongnum::MappedLongnum(const std::filesystem::path &dir) {
+  auto name{(dir / "longnum-XXXXXX").string()};
+  fd = mkstemp(name.data());
+  if (fd == -1) {
+    throw_errno("Can't create a scratch file");
+  }
+  unlink(name.c_str());
+}
+
+MappedLongnum::MappedLongnum(const Longnum &other,
+                             const std::filesystem::path &dir)
+    : MappedLongnum(dir) {
+  resize(other.digits.size());
+  std::copy(other.digits.begin(), other.digits.end(), data);
+  precision = other.precision;
+  negative = other.negative;
+}
+
+Longnum MappedLongnum::to_longnum() const {
+  Longnum res{};
+  res.digits = Digits(data, data + length);
+  res.precision = precision;
+  res.negative = negative;
+  return res;
+}
+
+std::size_t MappedLongnum::size() const { return length; }
+
+std::span<const MappedLongnum::Digit> MappedLongnum::limbs() const {
+  return {data, length};
+}
+
+MappedLongnum::Precision MappedLongnum::get_precision() const {
+  return precision;
+}
+
+int MappedLongnum::sign() const {
+  if (length == 0) {
+    return 0;
+  }
+  return negative ? -1 : 1;
+}
+
+MappedLongnum::MappedLongnum(std::istream &is,
+                             const std::filesystem::path &dir)
+    : MappedLongnum(dir) {
+  std::array<char, header_size> header{};
+  if (!is.read(header.data(), header.size()) ||
+      static_cast<unsigned char>(header[0]) > 1) {
+    throw std::invalid_argument("Malformed binary number");
+  }
+
+  // The size in the header is not trusted: the file grows with the data
+  // actually read.
+  const auto bytes{get_le(header.data() + 5, 8)};
+  std::string buf{};
+  for (std::uint64_t done{0}; done < bytes;) {
+    const auto count{static_cast<std::size_t>(
+        std::min<std::uint64_t>(bytes - done, io_block))};
+    buf.resize(count);
+    if (!is.read(buf.data(), static_cast<std::streamsize>(count))) {
+      throw std::invalid_argument("Malformed binary number");
+    }
+
+    const auto limbs{(done + count + sizeof(Digit) - 1) / sizeof(Digit)};
+    if (limbs > length) {
+      resize(std::max<std::size_t>(limbs, 2 * length));
+    }
+    for (std::size_t i{0}; i < count; i++) {
+      const auto pos{done + i};
+      data[pos / sizeof(Digit)] |=
+          static_cast<Digit>(static_cast<unsigned char>(buf[i]))
+          << (pos % sizeof(Digit) * 8);
+    }
+    done += count;
+  }
+
+  auto size{length};
+  while (size > 0 && data[size - 1] == 0) {
+    size--;
+  }
+  resize(size);
+  precision = static_cast<Precision>(
+      static_cast<std::uint32_t>(get_le(header.data() + 1, 4)));
+  negative = header[0] == 1 && length != 0;
+}
+
+void MappedLongnum::write_binary(std::ostream &os) const {
+  advise(MADV_SEQUENTIAL);
+  const auto bits{length == 0 ? 0
+                              : (length - 1) * kernels::digit_bits +
+                                    std::bit_width(data[length - 1])};
+  const auto bytes{(bits + 7) / 8};
+
+  std::string buf{};
+  buf.reserve(std::max(header_size, std::min(bytes, io_block)));
+  buf.push_back(static_cast<char>(negative ? 1 : 0));
+  put_le(buf, static_cast<std::uint32_t>(precision), 4);
+  put_le(buf, bytes, 8);
+  for (std::size_t i{0}; i < bytes; i++) {
+    if (buf.size() == io_block) {
+      os.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+      buf.clear();
+    }
+    buf.push_back(static_cast<char>(data[i / sizeof(Digit)] >>
+                                    (i % sizeof(Digit) * 8)));
+  }
+
+  os.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+}
+
+MappedLongnum MappedLongnum::add(const MappedLongnum &a,
+                                 const MappedLongnum &b,
+                                 const std::filesystem::path &dir) {
+  return combine(a, b, dir, false);
+}
+
+MappedLongnum MappedLongnum::subtract(const MappedLongnum &a,
+                                      const MappedLongnum &b,
+                                      const std::filesystem::path &dir) {
+  return combine(a, b, dir, true);
+}
+
+MappedLongnum MappedLongnum::combine(const MappedLongnum &a,
+                                     const MappedLongnum &b,
+                                     const std::filesystem::path &dir,
+                                     bool flip) {
+  a.advise(MADV_SEQUENTIAL);
+  b.advise(MADV_SEQUENTIAL);
+
+  // Both are aligned at the binary point of the larger precision.
+  MappedLongnum res(dir);
+  res.precision = std::max(a.precision, b.precision);
+  auto align{[&](const MappedLongnum &x) {
+    const auto shift{static_cast<std::uint64_t>(
+        static_cast<std::int64_t>(res.precision) - x.precision)};
+    return Shifted{x.limbs(),
+                   static_cast<std::size_t>(shift / kernels::digit_bits),
+                   static_cast<int>(shift % kernels::digit_bits)};
+  }};
+  const auto x{align(a)};
+  const auto y{align(b)};
+  const bool x_negative{a.negative};
+  const bool y_negative{b.negative != flip};
+  const auto size{std::max(x.size(), y.size())};
+
+  if (x.size() == 0 || y.size() == 0 || x_negative == y_negative) {
+    res.resize(size + 1);
+    res.advise(MADV_SEQUENTIAL);
+    kernels::DoubleDigit carry{0};
+    for (std::size_t i{0}; i < size; i++) {
+      carry += kernels::DoubleDigit{x[i]} + y[i];
+      res.data[i] = static_cast<Digit>(carry);
+      carry >>= kernels::digit_bits;
+    }
+    res.data[size] = static_cast<Digit>(carry);
+    res.negative = x.size() != 0 ? x_negative : y_negative;
+  } else {
+    // The larger absolute value is found from the top.
+    std::size_t top{size};
+    while (top > 0 && x[top - 1] == y[top - 1]) {
+      top--;
+    }
+    if (top == 0) {
+      return res;
+    }
+    const bool swapped{x[top - 1] < y[top - 1]};
+    const auto &big{swapped ? y : x};
+    const auto &small{swapped ? x : y};
+
+    res.resize(top);
+    res.advise(MADV_SEQUENTIAL);
+    Digit borrow{0};
+    for (std::size_t i{0}; i < top; i++) {
+      const auto val{kernels::DoubleDigit{big[i]} - small[i] - borrow};
+      res.data[i] = static_cast<Digit>(val);
+      borrow = (val >> kernels::digit_bits) != 0 ? 1 : 0;
+    }
+    res.negative = swapped ? y_negative : x_negative;
+  }
+
+  auto used{res.length};
+  while (used > 0 && res.data[used - 1] == 0) {
+    used--;
+  }
+  res.resize(used);
+  if (res.length == 0) {
+    res.negative = false;
+  }
+  return res;
+}
+
+MappedLongnum MappedLongnum::multiply(const MappedLongnum &a,
+                                      const MappedLongnum &b,
+                                      const std::filesystem::path &dir,
+                                      std::size_t block_limbs) {
+  if (block_limbs == 0) {
+    throw std::invalid_argument("Block size must not be 0");
+  }
+
+  MappedLongnum res(dir);
+  res.precision = a.precision + b.precision;
+  if (a.sign() == 0 || b.sign() == 0) {
+    return res;
+  }
+  res.negative = a.negative != b.negative;
+
+  if (a.length + b.length <= block_limbs) {
+    const auto prod{kernels::mul(Digits(a.data, a.data + a.length),
+                                 Digits(b.data, b.data + b.length))};
+    res.resize(prod.size());
+    std::copy(prod.begin(), prod.end(), res.data);
+    return res;
+  }
+
+  // Limbs are split into coefficients small enough that no coefficient of
+  // the product, a sum of at most 2^31 products of two coefficients, reaches
+  // the modulus.
+  constexpr int piece_bits{16};
+  constexpr std::size_t pieces{kernels::digit_bits / piece_bits};
+  constexpr std::uint64_t piece_mask{(std::uint64_t{1} << piece_bits) - 1};
+
+  const auto points{pieces * (a.length + b.length) - 1};
+  if (points > (std::uint64_t{1} << field::max_log_order)) {
+    throw std::invalid_argument("Product is too big");
+  }
+  const FourStep transform(std::bit_width(points - 1));
+  const auto size{transform.rows * transform.cols};
+  const auto batch{std::max<std::size_t>(
+      block_limbs * sizeof(Digit) / sizeof(std::uint64_t) / transform.rows,
+      1)};
+
+  // The operands are read column by column, not in order.
+  a.advise(MADV_NORMAL);
+  b.advise(MADV_NORMAL);
+
+  auto coefficients{[&](const MappedLongnum &x) {
+    return [&x](std::size_t n) -> std::uint64_t {
+      const auto limb{n / pieces};
+      if (limb >= x.length) {
+        return 0;
+      }
+      return (x.data[limb] >> (n % pieces * piece_bits)) & piece_mask;
+    };
+  }};
+
+  const bool square{&a == &b};
+  Scratch fa(dir, size);
+  transform.columns(fa, batch, false, coefficients(a));
+  std::optional<Scratch> fb{};
+  if (!square) {
+    fb.emplace(dir, size);
+    transform.columns(*fb, batch, false, coefficients(b));
+    for (std::size_t r{0}; r < transform.rows; r++) {
+      auto row{fb->row(r * transform.cols)};
+      transform.twiddle(row, r, false, 1);
+      forward_transform(row, transform.cols, transform.row_roots);
+    }
+  }
+
+  // Rows of the product are transformed back right away.
+  for (std::size_t r{0}; r < transform.rows; r++) {
+    auto row{fa.row(r * transform.cols)};
+    transform.twiddle(row, r, false, 1);
+    forward_transform(row, transform.cols, transform.row_roots);
+    const auto other{square ? row : fb->row(r * transform.cols)};
+    for (std::size_t n{0}; n < transform.cols; n++) {
+      row[n] = field::mul(row[n], other[n]);
+    }
+    inverse_transform(row, transform.cols, transform.row_roots);
+    transform.twiddle(row, r, true, transform.inverse_size);
+  }
+  fb.reset();
+  transform.columns(fa, batch, true, [&fa](std::size_t n) { return fa[n]; });
+
+  // Coefficients go out with their carries in order.
+  res.resize(a.length + b.length);
+  res.advise(MADV_SEQUENTIAL);
+  std::uint64_t carry{0};
+  for (std::size_t i{0}; i < res.length; i++) {
+    Digit limb{0};
+    for (std::size_t j{0}; j < pieces; j++) {
+      const auto n{i * pieces + j};
+      carry += n < size ? fa[n] : 0;
+      limb |= static_cast<Digit>((carry & piece_mask) << (j * piece_bits));
+      carry >>= piece_bits;
+    }
+    res.data[i] = limb;
+  }
+
+  auto used{res.length};
+  while (used > 0 && res.data[used - 1] == 0) {
+    used--;
+  }
+  res.resize(used);
+  return res;
+}
+
+void MappedLongnum::resize(std::size_t size) {
+  if (size == length) {
+    return;
+  }
+
+  if (data != nullptr) {
+    munmap(data, length * sizeof(Digit));
+    data = nullptr;
+    length = 0;
+  }
+  if (ftruncate(fd, static_cast<off_t>(size * sizeof(Digit))) == -1) {
+    throw_errno("Can't resize a scratch file");
+  }
+  if (size == 0) {
+    return;
+  }
+
+  auto ptr{mmap(nullptr, size * sizeof(Digit), PROT_READ | PROT_WRITE,
+                MAP_SHARED, fd, 0)};
+  if (ptr == MAP_FAILED) {
+    throw_errno("Can't map a scratch file");
+  }
+  data = static_cast<Digit *>(ptr);
+  length = size;
+}
+
+void MappedLongnum::advise(int advice) const {
+  if (data != nullptr) {
+    madvise(data, length * sizeof(Digit), advice);
+  }
+}
+
+void MappedLongnum::release() {
+  if (data != nullptr) {
+    munmap(data, length * sizeof(Digit));
+  }
+  if (fd != -1) {
+    close(fd);
+  }
+  data = nullptr;
+  length = 0;
+  fd = -1;
+}
+
+} // namespace ln
@@ -0,0 +1,97 @@
+#include "doctest.h"
+
+#include <vector>
+
+#include "longnum_accumulator.hpp"
+
+using namespace std;
+using namespace ln;
+
+static Longnum exact_product(const Longnum &a, const Longnum &b) {
+    Longnum res{a};
+    res.set_precision(a.get_precision() + b.get_precision());
+    return res *= b;
+}
+
+TEST_CASE("Accumulator") {
+    vector<Longnum> terms{};
+    Longnum x(1, 40);
+    for (int i{0}; i < 300; i++) {
+        x *= Longnum(1.375);
+        x.set_precision(40 + i % 7);
+        if (i % 3 == 0) {
+            x.flip_sign();
+        }
+        terms.push_back(x);
+    }
+
+    Longnum expected(0, 46);
+    for (const auto &t : terms) {
+        expected += t;
+    }
+
+    SUBCASE("Exact sums") {
+        Accumulator acc(46);
+        CHECK(acc.value().sign() == 0);
+        CHECK(acc.value().get_precision() == 46);
+
+        for (const auto &t : terms) {
+            acc += t;
+        }
+        CHECK(acc.value() == expected);
+        CHECK(acc.value().get_precision() == 46);
+        CHECK(sum(terms) == expected);
+
+        for (const auto &t : terms) {
+            acc -= t;
+        }
+        CHECK(acc.value().sign() == 0);
+
+        acc -= Longnum(5);
+        acc += Longnum(0.25);
+        CHECK(acc.value() == Longnum(-4.75));
+    }
+
+    SUBCASE("Frequent normalization") {
+        Accumulator acc(46);
+        for (const auto &t : terms) {
+            acc.adds_left = 1;
+            acc += t;
+            acc -= Longnum(1);
+        }
+        CHECK(acc.value() == expected - Longnum(300));
+    }
+
+    SUBCASE("Finer terms are truncated") {
+        Accumulator acc(2);
+        acc += Longnum(1.875);
+        acc -= Longnum(0.125);
+        CHECK(acc.value() == Longnum(1.75));
+        CHECK(acc.value().get_precision() == 2);
+
+        acc.clear();
+        CHECK(acc.value().sign() == 0);
+    }
+
+    SUBCASE("Products") {
+        Accumulator acc(100);
+        acc.add_product(terms[10], terms[20]);
+        acc.add_product(terms[11], -terms[21]);
+        acc.add_product(Longnum(0), terms[21]);
+        CHECK(acc.value() == exact_product(terms[10], terms[20]) -
+                                 exact_product(terms[11], terms[21]));
+
+        vector<Longnum> a{Longnum(1.5), Longnum(-2), Longnum(0.25)};
+        vector<Longnum> b{Longnum(4), Longnum(3), Longnum(-0.5)};
+        CHECK(dot(a, b) == Longnum(-0.125));
+        CHECK_THROWS(dot(a, vector<Longnum>(2)));
+
+        Longnum naive(0, 92);
+        for (size_t i{0}; i + 1 < terms.size(); i++) {
+            naive += exact_product(terms[i], terms[i + 1]);
+        }
+        vector<Longnum> shifted(terms.begin() + 1, terms.end());
+        auto res{dot(span(terms).first(terms.size() - 1), shifted)};
+        CHECK(res == naive);
+    }
+}
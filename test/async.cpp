@@ -0,0 +1,86 @@
+#include "doctest.h"
+
+#include <atomic>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+#include "longnum_async.hpp"
+
+using namespace std;
+using namespace ln;
+
+static Longnum power(Longnum base, unsigned exp) {
+    Longnum res(1);
+    for (unsigned i{0}; i < exp; i++) {
+        res *= base;
+    }
+    return res;
+}
+
+TEST_CASE("Asynchronous operations") {
+    ThreadPool pool(2);
+    AsyncContext ctx(pool);
+
+    Longnum a{power(3, 4000)};
+    Longnum b{power(7, 2500) + 1};
+    // Big enough to be reported in many blocks.
+    Longnum big{power(a, 8)};
+
+    SUBCASE("Construction") { CHECK_THROWS(ThreadPool(0)); }
+
+    SUBCASE("Same results as synchronous operations") {
+        auto product{ctx.multiply(a, b)};
+        auto quotient{ctx.div_mod(a, b)};
+        auto str{ctx.to_string(Longnum(-1234.5625), 3)};
+        auto parsed{ctx.parse(a.to_string(0), 0)};
+
+        CHECK(product.get() == a * b);
+        auto [q, r] = quotient.get();
+        auto [expected_q, expected_r] = a.div_mod(b);
+        CHECK(q == expected_q);
+        CHECK(r == expected_r);
+        CHECK(str.get() == "-1234.562");
+        CHECK(parsed.get() == a);
+    }
+
+    SUBCASE("Errors are passed to futures") {
+        auto quotient{ctx.div_mod(a, 0)};
+        CHECK_THROWS(quotient.get());
+        auto parsed{ctx.parse("12x", 0)};
+        CHECK_THROWS(parsed.get());
+    }
+
+    SUBCASE("Progress") {
+        vector<double> reports{};
+        auto product{ctx.multiply(big, big, {}, [&](double fraction) {
+            reports.push_back(fraction);
+        })};
+        product.get();
+
+        REQUIRE(reports.size() >= 2);
+        CHECK(reports.back() == 1.0);
+        bool increasing{true};
+        for (size_t i{1}; i < reports.size(); i++) {
+            increasing = increasing && reports[i - 1] < reports[i];
+        }
+        CHECK(increasing);
+    }
+
+    SUBCASE("Cancellation") {
+        stop_source stop{};
+        stop.request_stop();
+        auto product{ctx.multiply(a, b, stop.get_token())};
+        CHECK_THROWS_AS(product.get(), Cancelled);
+
+        // Cancelled in the middle of the work.
+        stop_source later{};
+        atomic<bool> reported{false};
+        auto square{ctx.multiply(big, big, later.get_token(), [&](double) {
+            reported = true;
+            later.request_stop();
+        })};
+        CHECK_THROWS_AS(square.get(), Cancelled);
+        CHECK(reported);
+    }
+}
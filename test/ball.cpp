@@ -0,0 +1,80 @@
+#include "doctest.h"
+
+#include "longnum_ball.hpp"
+
+using namespace std;
+using namespace ln;
+using namespace lits;
+
+TEST_CASE("Balls") {
+    SUBCASE("Construction and bounds") {
+        Ball exact(Longnum(1.25));
+        CHECK(exact.mid() == Longnum(1.25));
+        CHECK(exact.rad().sign() == 0);
+        CHECK(exact.contains(Longnum(1.25)));
+        CHECK(!exact.contains(Longnum(1.5)));
+        CHECK(exact.certified_precision() ==
+              numeric_limits<Longnum::Precision>::max());
+
+        Ball x(Longnum(3), Longnum(-0.125));
+        CHECK(x.rad() == Longnum(0.125));
+        CHECK(x.lower() == Longnum(2.875));
+        CHECK(x.upper() == Longnum(3.125));
+        CHECK(x.certified_precision() == 3);
+        CHECK(Ball(Longnum(3), Longnum(0.1)).certified_precision() == 3);
+
+        // Radius is rounded up to 53 significant bits
+        Longnum big(1);
+        big <<= 100;
+        big += 1;
+        Ball y(0, big);
+        CHECK(y.rad() >= big);
+        CHECK(y.rad() - big <= (Longnum(1) << 48));
+    }
+
+    SUBCASE("Arithmetic encloses the exact result") {
+        Ball a(Longnum(2.5), Longnum(0.25));
+        Ball b(Longnum(-1.5), Longnum(0.125));
+
+        CHECK((a + b).mid() == 1);
+        CHECK((a + b).rad() == Longnum(0.375));
+        CHECK((a - b).mid() == 4);
+        CHECK((-a).mid() == Longnum(-2.5));
+
+        // Products and quotients of the ends must be inside.
+        for (const Longnum &x : {a.lower(), a.upper()}) {
+            for (const Longnum &y : {b.lower(), b.upper()}) {
+                CHECK((a * b).contains(x * y));
+                CHECK((a / b).contains(div(x, y, 60)));
+                CHECK((b / a).contains(div(y, x, 60)));
+            }
+        }
+
+        CHECK_THROWS(a / Ball(Longnum(0.1), Longnum(0.2)));
+        CHECK_THROWS(a / Ball(0));
+    }
+
+    SUBCASE("Truncation errors are counted") {
+        Ball third(Longnum(1, 100));
+        third /= Ball(Longnum(3));
+        CHECK(third.certified_precision() >= 99);
+
+        Longnum exact_third(1, 300);
+        exact_third /= 3;
+        CHECK(third.contains(exact_third));
+
+        Ball x{third};
+        for (int i{0}; i < 50; i++) {
+            x *= third;
+            x += third;
+        }
+        CHECK(x.certified_precision() >= 80);
+
+        Longnum y{exact_third};
+        for (int i{0}; i < 50; i++) {
+            y *= exact_third;
+            y += exact_third;
+        }
+        CHECK(x.contains(y));
+    }
+}
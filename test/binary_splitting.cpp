@@ -0,0 +1,70 @@
+#include "doctest.h"
+
+#include <stdexcept>
+
+#include "binary_splitting.hpp"
+
+using namespace std;
+using namespace ln;
+
+// e = sum of 1 / n!
+static SplitSeries e_series() {
+    SplitSeries series{};
+    series.p = [](uint64_t) { return Longnum(1); };
+    series.q = [](uint64_t n) { return Longnum(n == 0 ? 1 : n); };
+    series.a = [](uint64_t) { return Longnum(1); };
+    return series;
+}
+
+TEST_CASE("Binary splitting") {
+    auto series{e_series()};
+
+    SUBCASE("Sums") {
+        auto empty{binary_split(series, 5, 5)};
+        CHECK(empty.p == 1);
+        CHECK(empty.q == 1);
+        CHECK(empty.t.sign() == 0);
+
+        // 1 + 1 + 1/2 + 1/6 = 16 / 6
+        auto res{binary_split(series, 0, 4)};
+        CHECK(res.q == 6);
+        CHECK(res.t == 16);
+
+        auto sum{binary_split(series, 0, 200)};
+        auto e{div(sum.t, sum.q, 400)};
+        CHECK(e.to_string(50) ==
+              "2.71828182845904523536028747135266249775724709369995");
+    }
+
+    SUBCASE("Merging") {
+        auto whole{binary_split(series, 3, 40)};
+        auto merged{merge(binary_split(series, 3, 17),
+                          binary_split(series, 17, 40))};
+        CHECK(merged.p == whole.p);
+        CHECK(merged.q == whole.q);
+        CHECK(merged.t == whole.t);
+    }
+
+    SUBCASE("Worker processes") {
+        auto local{binary_split(series, 0, 500)};
+        for (size_t workers : {1, 3, 4}) {
+            auto res{distributed_split(series, 0, 500, workers)};
+            CHECK(res.p == local.p);
+            CHECK(res.q == local.q);
+            CHECK(res.t == local.t);
+        }
+
+        auto few{distributed_split(series, 10, 12, 8)};
+        CHECK(few.q == 110);
+
+        CHECK_THROWS(distributed_split(series, 0, 10, 0));
+
+        series.a = [](uint64_t n) {
+            if (n == 7) {
+                throw runtime_error("Broken term");
+            }
+            return Longnum(1);
+        };
+        CHECK_THROWS(distributed_split(series, 0, 10, 2));
+    }
+}
@@ -0,0 +1,147 @@
+#include "doctest.h"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "longnum_checkpoint.hpp"
+
+using namespace std;
+using namespace ln;
+
+static size_t count_files(const filesystem::path &dir) {
+    size_t res{0};
+    for ([[maybe_unused]] const auto &entry :
+         filesystem::directory_iterator{dir}) {
+        res++;
+    }
+    return res;
+}
+
+TEST_CASE("Checkpoints") {
+    auto dir{filesystem::temp_directory_path() / "longnum-checkpoint-test"};
+    filesystem::remove_all(dir);
+
+    vector<Longnum> state{Longnum(1, 64), Longnum(-2.5), Longnum(0)};
+    for (int i{0}; i < 200; i++) {
+        state[0] *= 3;
+    }
+
+    SUBCASE("Nothing saved") {
+        Checkpointer ckpt(dir);
+        CHECK(!ckpt.load());
+    }
+
+    SUBCASE("Save and resume") {
+        {
+            Checkpointer ckpt(dir);
+            ckpt.save(1, state);
+            state[1] += 1;
+            ckpt.save(2, state);
+        }
+
+        Checkpointer ckpt(dir);
+        auto snapshot{ckpt.load()};
+        REQUIRE(snapshot);
+        CHECK(snapshot->step == 2);
+        REQUIRE(snapshot->state.size() == 3);
+        for (size_t i{0}; i < 3; i++) {
+            CHECK(snapshot->state[i] == state[i]);
+            CHECK(snapshot->state[i].get_precision() ==
+                  state[i].get_precision());
+        }
+    }
+
+    SUBCASE("Unchanged numbers are not rewritten") {
+        Checkpointer ckpt(dir);
+        ckpt.save(1, state);
+        ckpt.wait();
+        auto before{ckpt.written_files};
+
+        state[2] = 5;
+        ckpt.save(2, state);
+        ckpt.wait();
+        auto after{ckpt.written_files};
+
+        CHECK(after[0] == before[0]);
+        CHECK(after[1] == before[1]);
+        CHECK(after[2] != before[2]);
+
+        // The manifest, one file per number and the other file of the
+        // changed one
+        CHECK(count_files(dir) == 5);
+        CHECK(ckpt.load()->state[2] == 5);
+    }
+
+    SUBCASE("Only changed blocks are rewritten") {
+        constexpr size_t bits{Checkpointer::block_size * 8};
+        Longnum big(1);
+        big <<= 4 * bits;
+        vector<Longnum> nums{big + 1, Longnum(7)};
+
+        Checkpointer ckpt(dir);
+        ckpt.save(1, nums);
+        ckpt.wait();
+        nums[0] += 2;
+        ckpt.save(2, nums);
+        ckpt.wait();
+        // Every block of both numbers once, then the other file of the
+        // changed one in full
+        CHECK(ckpt.written_blocks == 5 + 1 + 5);
+
+        // The other file holds the first snapshot now, and only the block
+        // with the low limbs differs from it.
+        nums[0] += 4;
+        ckpt.save(3, nums);
+        ckpt.wait();
+        CHECK(ckpt.written_blocks == 12);
+        CHECK(ckpt.load()->state[0] == big + 7);
+
+        // A shorter number cuts the file.
+        nums[0] = Longnum(5, 3);
+        ckpt.save(4, nums);
+        ckpt.wait();
+        auto snapshot{ckpt.load()};
+        CHECK(snapshot->state[0] == 5);
+        CHECK(snapshot->state[0].get_precision() == 3);
+        CHECK(snapshot->state[1] == 7);
+    }
+
+    SUBCASE("Files of the latest snapshot are kept on restart") {
+        {
+            Checkpointer ckpt(dir);
+            ckpt.save(1, state);
+        }
+        state[0] += 1;
+        {
+            Checkpointer ckpt(dir);
+            ckpt.save(2, state);
+        }
+
+        Checkpointer ckpt(dir);
+        auto snapshot{ckpt.load()};
+        REQUIRE(snapshot);
+        CHECK(snapshot->step == 2);
+        CHECK(snapshot->state[0] == state[0]);
+        CHECK(ckpt.written_files == vector<string>{"slot-0-1.bin",
+                                                  "slot-1-1.bin",
+                                                  "slot-2-1.bin"});
+    }
+
+    SUBCASE("Damaged snapshot") {
+        {
+            Checkpointer ckpt(dir);
+            ckpt.save(1, state);
+        }
+        for (const auto &entry : filesystem::directory_iterator{dir}) {
+            if (entry.path().filename() != "manifest") {
+                filesystem::resize_file(entry.path(), 3);
+            }
+        }
+
+        Checkpointer ckpt(dir);
+        CHECK_THROWS(ckpt.load());
+    }
+
+    filesystem::remove_all(dir);
+}
@@ -178,3 +178,87 @@ TEST_CASE("Literals") {
         CHECK(num3.get_precision() > 0);
     }
 }
+
+TEST_CASE("Constant evaluation") {
+    static_assert(Longnum(2) + Longnum(3) == Longnum(5));
+    static_assert((Longnum(7, 10) * Longnum(-3)).sign() < 0);
+    static_assert(Longnum(-7).div_mod(Longnum(2)).second == Longnum(1));
+    static_assert(Longnum(1, 5).set_precision(0).get_precision() == 0);
+
+    constexpr auto third{bake<[] { return Longnum(1, 128) / 3; }>()};
+    static_assert(third.precision == 128);
+
+    Longnum x{third};
+    CHECK(x == Longnum(1, 128) / 3);
+    CHECK(x.to_string(5) == "0.33333");
+
+    constexpr auto minus_big{bake<[] {
+        Longnum res(-1);
+        for (int i{0}; i < 10; i++) {
+            res *= 1000;
+        }
+        return res;
+    }>()};
+    CHECK(Longnum(minus_big).to_string(0) == "-1" + string(30, '0'));
+
+    static_assert([] {
+        Longnum a(12345, 40);
+        Longnum b{a};
+        b += 1;
+        return a == Longnum(12345) && b == Longnum(12346);
+    }());
+}
+
+TEST_CASE("Shared limbs") {
+    Longnum a(1);
+    for (int i{0}; i < 100; i++) {
+        a *= 3;
+    }
+    const Longnum expected{a};
+
+    SUBCASE("Copies share limbs") {
+        Longnum b{a};
+        CHECK(a.digits.shared());
+        CHECK(&a.digits.get() == &b.digits.get());
+
+        Longnum c{};
+        c = b;
+        CHECK(&c.digits.get() == &a.digits.get());
+    }
+
+    SUBCASE("Writing copies limbs first") {
+        Longnum b{a};
+        b += 1;
+        CHECK(!b.digits.shared());
+        CHECK(&a.digits.get() != &b.digits.get());
+        CHECK(a == expected);
+        CHECK(b == expected + 1);
+
+        Longnum c{a};
+        c.set_precision(10);
+        c.flip_sign();
+        CHECK(a == expected);
+        CHECK(c == -expected);
+
+        Longnum d{a};
+        d >>= 1;
+        CHECK(a == expected);
+    }
+
+    SUBCASE("Results of operators") {
+        Longnum b{a};
+        auto c{b * b};
+        CHECK(b == expected);
+        CHECK(c == expected * expected);
+        CHECK(a - b == 0);
+        CHECK(a == expected);
+    }
+
+    SUBCASE("Zero doesn't allocate") {
+        Longnum zero{};
+        CHECK(zero.digits.buffer == nullptr);
+        Longnum copy{zero};
+        CHECK(!copy.digits.shared());
+        CHECK(copy.digits.empty());
+    }
+}
@@ -0,0 +1,123 @@
+#include "doctest.h"
+
+#include "decimal_longnum.hpp"
+
+#include <sstream>
+#include <string>
+
+using namespace std;
+using namespace ln;
+
+TEST_CASE("Decimal numbers") {
+    SUBCASE("Decimal I/O") {
+        auto x{DecimalLongnum::from_string("-1234567890123.4500")};
+        CHECK(x.sign() == -1);
+        CHECK(x.get_scale() == 4);
+        CHECK(x.limbs.size() == 2);
+        CHECK(x.to_string() == "-1234567890123.4500");
+        CHECK(x.to_string(1) == "-1234567890123.4");
+        CHECK(x.to_string(6) == "-1234567890123.450000");
+        CHECK(x.to_string(0) == "-1234567890123");
+
+        CHECK(DecimalLongnum::from_string("0.000000000001").to_string() ==
+              "0.000000000001");
+        CHECK(DecimalLongnum::from_string("+7").to_string() == "7");
+        CHECK(DecimalLongnum::from_string("-0.00").sign() == 0);
+        CHECK(DecimalLongnum::from_string("-0.00").to_string() == "0.00");
+        CHECK(DecimalLongnum(0).to_string() == "0");
+        CHECK(DecimalLongnum(-1000000000).to_string() == "-1000000000");
+
+        string big(1000, '9');
+        big += ".5";
+        CHECK(DecimalLongnum::from_string(big).to_string() == big);
+
+        ostringstream os;
+        os.precision(2);
+        os << DecimalLongnum::from_string("3.14159");
+        CHECK(os.str() == "3.14");
+
+        CHECK_THROWS(DecimalLongnum::from_string(""));
+        CHECK_THROWS(DecimalLongnum::from_string("-"));
+        CHECK_THROWS(DecimalLongnum::from_string(".5"));
+        CHECK_THROWS(DecimalLongnum::from_string("5."));
+        CHECK_THROWS(DecimalLongnum::from_string("1e5"));
+        CHECK_THROWS(DecimalLongnum::from_string("1.2.3"));
+    }
+
+    SUBCASE("Arithmetic") {
+        auto a{DecimalLongnum::from_string("999999999.99")};
+        auto b{DecimalLongnum::from_string("0.011")};
+
+        CHECK((a + b).to_string() == "1000000000.001");
+        CHECK((a - b).to_string() == "999999999.979");
+        CHECK((b - a).to_string() == "-999999999.979");
+        CHECK((a - a).sign() == 0);
+        CHECK((a * b).to_string() == "10999999.99989");
+        CHECK((a * -b).get_scale() == 5);
+        CHECK((-a * -b) == a * b);
+        CHECK((a * 3).to_string() == "2999999999.97");
+        CHECK((a / b).to_string() == "90909090908.181");
+        CHECK((-a / b).to_string() == "-90909090908.181");
+        CHECK((DecimalLongnum(1) / DecimalLongnum(3)).sign() == 0);
+        CHECK((DecimalLongnum(1).set_scale(20) / 3).to_string() ==
+              "0." + string(20, '3'));
+        CHECK_THROWS(a / DecimalLongnum(0));
+
+        DecimalLongnum c{a};
+        c += c;
+        CHECK(c.to_string() == "1999999999.98");
+        c -= c;
+        CHECK(c.sign() == 0);
+    }
+
+    SUBCASE("Comparison") {
+        CHECK(DecimalLongnum::from_string("1.50") ==
+              DecimalLongnum::from_string("1.5"));
+        CHECK(DecimalLongnum::from_string("1.5") < 2);
+        CHECK(DecimalLongnum::from_string("-1.5") < -1);
+        CHECK(DecimalLongnum::from_string("-1.5") > -2);
+        CHECK(DecimalLongnum(-3) < DecimalLongnum(0));
+        CHECK(DecimalLongnum::from_string("0.000000001") > 0);
+    }
+
+    SUBCASE("Scale") {
+        auto x{DecimalLongnum::from_string("-12.3456789")};
+        CHECK(x.set_scale(2).to_string() == "-12.34");
+        CHECK(x.set_scale(12).to_string() == "-12.340000000000");
+        CHECK(x.set_scale(0).to_string() == "-12");
+        CHECK(DecimalLongnum::from_string("-0.5").set_scale(0).sign() == 0);
+    }
+
+    SUBCASE("Longnum conversions") {
+        DecimalLongnum x(Longnum(-1234.5625));
+        CHECK(static_cast<Longnum::Precision>(x.get_scale()) ==
+              Longnum(-1234.5625).get_precision());
+        CHECK(x == DecimalLongnum::from_string("-1234.5625"));
+        CHECK(x.to_longnum(4) == Longnum(-1234.5625));
+
+        CHECK(DecimalLongnum(Longnum(0)).sign() == 0);
+        CHECK(DecimalLongnum(Longnum(48).set_precision(-4)) == 48);
+
+        auto tenth{DecimalLongnum::from_string("0.1").to_longnum(4)};
+        CHECK(tenth.to_string(4) == "0.0625");
+        CHECK_THROWS(DecimalLongnum(1).to_longnum(-1));
+
+        // Large enough for several levels of splitting
+        Longnum big(1);
+        for (int i{0}; i < 3000; i++) {
+            big *= 7;
+        }
+        big = -big;
+        DecimalLongnum d(big);
+        CHECK(d.to_string() == big.to_string(0));
+        CHECK(d.to_longnum(0) == big);
+        CHECK(DecimalLongnum::from_string(big.to_string(0)) == d);
+
+        Longnum third(1, 2000);
+        third /= 3;
+        DecimalLongnum t(third);
+        CHECK(t.get_scale() == 2000);
+        CHECK(t.to_longnum(2000) == third);
+        CHECK(t.to_string(500) == third.to_string(500));
+    }
+}
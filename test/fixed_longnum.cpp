@@ -0,0 +1,58 @@
+#include "doctest.h"
+
+#include "fixed_longnum.hpp"
+
+#include <vector>
+
+using namespace std;
+using namespace ln;
+
+using Fixed = FixedLongnum<256, 256>;
+using Small = FixedLongnum<10, 5>;
+
+static_assert(Fixed::limb_count == (513 + Longnum::digit_bits - 1) /
+                                       Longnum::digit_bits);
+static_assert(Fixed(6) * Fixed(7) == Fixed(42));
+static_assert(Fixed(7) / Fixed(2) * Fixed(2) == Fixed(7));
+static_assert(Fixed(-3) + Fixed(5) == Fixed(2));
+static_assert(Fixed(-3) < Fixed(2));
+static_assert(Small(1023) + Small(1) == Small(-1024));
+
+TEST_CASE("Fixed-width numbers") {
+    SUBCASE("Conversions") {
+        Fixed a(Longnum(-12.375));
+        CHECK(static_cast<Longnum>(a) == Longnum(-12.375));
+        CHECK(static_cast<Longnum>(a).get_precision() == 256);
+        CHECK(a.to_string(3) == "-12.375");
+        CHECK(a.sign() < 0);
+        CHECK(Fixed().sign() == 0);
+
+        Small b(Longnum(1.0 / 3));
+        CHECK(static_cast<Longnum>(b) == Longnum(0.3125));
+    }
+
+    SUBCASE("Arithmetic matches Longnum") {
+        vector<Longnum> xs{Longnum(3.5), Longnum(-2.25), Longnum(0),
+                           Longnum(123456789), Longnum(-0.125)};
+        for (auto &x : xs) {
+            for (auto &y : xs) {
+                Longnum lx{x}, ly{y};
+                lx.set_precision(256);
+                ly.set_precision(256);
+
+                Fixed fx(x), fy(y);
+                CHECK(static_cast<Longnum>(fx + fy) == lx + ly);
+                CHECK(static_cast<Longnum>(fx - fy) == lx - ly);
+                CHECK(static_cast<Longnum>(fx * fy) == lx * ly);
+                CHECK((fx <=> fy) == (lx <=> ly));
+            }
+        }
+    }
+
+    SUBCASE("Division") {
+        Fixed third{Fixed(1) / Fixed(3)};
+        CHECK(third.to_string(70) == "0." + string(70, '3'));
+        CHECK((Fixed(-10) / Fixed(4)).to_string(2) == "-2.50");
+        CHECK_THROWS(Fixed(1) / Fixed(0));
+    }
+}
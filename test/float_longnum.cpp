@@ -0,0 +1,108 @@
+#include "doctest.h"
+
+#include "float_longnum.hpp"
+
+using namespace std;
+using namespace ln;
+using namespace lits;
+
+TEST_CASE("Floating-point numbers") {
+    SUBCASE("Conversions") {
+        FloatLongnum zero;
+        CHECK(zero.sign() == 0);
+        CHECK(static_cast<Longnum>(zero).sign() == 0);
+
+        FloatLongnum x(Longnum(-6.5));
+        CHECK(x.sign() == -1);
+        CHECK(x.mantissa() == -13);
+        CHECK(x.exponent() == -1);
+        CHECK(static_cast<Longnum>(x) == Longnum(-6.5));
+        CHECK(x.to_string(2) == "-6.50");
+
+        // Zero-padded limbs are not stored
+        Longnum tiny(1, 100000);
+        tiny >>= 99990;
+        FloatLongnum y(tiny);
+        CHECK(y.mant.size() == 1);
+        CHECK(y.exponent() == -99990);
+        CHECK(static_cast<Longnum>(y) == tiny);
+
+        Longnum huge(3, 5000);
+        huge <<= 100000;
+        FloatLongnum z(huge);
+        CHECK(z.mant.size() == 1);
+        CHECK(z.exponent() == 100000);
+
+        CHECK_THROWS(FloatLongnum(Longnum(1), 0));
+    }
+
+    SUBCASE("Bit cap") {
+        // 2^70 - 1 has 70 significant bits
+        Longnum big(1);
+        big <<= 70;
+        big -= 1;
+
+        FloatLongnum x(big, 8);
+        CHECK(static_cast<Longnum>(x) == Longnum(255) << 62);
+        CHECK(FloatLongnum(-big, 8) == -x);
+
+        FloatLongnum y(big, 100);
+        CHECK(static_cast<Longnum>(y) == big);
+        y.set_bits(8);
+        CHECK(y == x);
+        CHECK_THROWS(y.set_bits(0));
+    }
+
+    SUBCASE("Arithmetic") {
+        FloatLongnum a(Longnum(2.75));
+        FloatLongnum b(Longnum(-0.125));
+
+        CHECK(static_cast<Longnum>(a + b) == Longnum(2.625));
+        CHECK(static_cast<Longnum>(a - b) == Longnum(2.875));
+        CHECK(static_cast<Longnum>(a * b) == Longnum(-0.34375));
+        CHECK(static_cast<Longnum>(a / b) == -22);
+        CHECK((a - a).sign() == 0);
+        CHECK_THROWS(a / FloatLongnum());
+
+        FloatLongnum third{FloatLongnum(1, 64) / FloatLongnum(3, 64)};
+        Longnum expected(1, 64);
+        expected /= 3;
+        CHECK(static_cast<Longnum>(third) == expected);
+
+        // Results have the larger cap
+        CHECK((FloatLongnum(1, 10) + FloatLongnum(1, 20)).get_bits() == 20);
+    }
+
+    SUBCASE("Operands of very different magnitudes") {
+        FloatLongnum one(1, 16);
+        Longnum eps(1, 1000);
+        eps >>= 1000;
+        FloatLongnum tiny(eps, 16);
+
+        // Truncated towards zero, like an exact computation would be
+        CHECK(one + tiny == one);
+        CHECK(static_cast<Longnum>(one - tiny) ==
+              Longnum(1) - (Longnum(1, 16) >> 16));
+        CHECK(static_cast<Longnum>(tiny - one) ==
+              (Longnum(1, 16) >> 16) - Longnum(1));
+        CHECK(tiny < one);
+        CHECK(-one < -tiny);
+        CHECK(tiny > FloatLongnum());
+        CHECK((one * tiny).exponent() == -1000);
+    }
+
+    SUBCASE("Matches Longnum") {
+        Longnum x(1, 200);
+        Longnum y(1, 200);
+        FloatLongnum fx(x, 400);
+        FloatLongnum fy(y, 400);
+        for (int i{0}; i < 30; i++) {
+            x = x * 3 + y;
+            y = y * 5 - x;
+            fx = fx * FloatLongnum(3) + fy;
+            fy = fy * FloatLongnum(5) - fx;
+        }
+        CHECK(static_cast<Longnum>(fx) == x);
+        CHECK(static_cast<Longnum>(fy) == y);
+    }
+}
@@ -0,0 +1,70 @@
+#include "doctest.h"
+
+#include "longnum_array.hpp"
+
+#include <vector>
+
+using namespace std;
+using namespace ln;
+
+TEST_CASE("Longnum array") {
+    vector<Longnum> xs{Longnum(3.5), Longnum(-2.25), Longnum(0),
+                       Longnum(123456789), Longnum(-0.125), Longnum(7)};
+    vector<Longnum> ys{Longnum(1.25), Longnum(-4), Longnum(-5.5),
+                       Longnum(987654321), Longnum(0.375), Longnum(7)};
+
+    for (auto &x : xs) {
+        x.set_precision(64);
+    }
+
+    SUBCASE("Conversions") {
+        LongnumArray a(xs, 2, 2);
+        CHECK(a.size() == xs.size());
+        CHECK(a.width() == 4);
+        CHECK(a.get_precision() == 2 * Longnum::digit_bits);
+        CHECK(a.to_vector() == xs);
+
+        a.set(2, Longnum(-1));
+        CHECK(a.get(2) == -1);
+        CHECK(a.get(3) == xs[3]);
+    }
+
+    SUBCASE("Arithmetic matches Longnum") {
+        LongnumArray a(xs, 2, 2);
+        LongnumArray b(ys, 2, 2);
+
+        auto sum{(a + b).to_vector()};
+        auto diff{(a - b).to_vector()};
+        auto prod{(a * b).to_vector()};
+        auto cmp{a.compare(b)};
+
+        for (size_t i{0}; i < xs.size(); i++) {
+            CHECK(sum[i] == xs[i] + ys[i]);
+            CHECK(diff[i] == xs[i] - ys[i]);
+            CHECK(prod[i] == xs[i] * ys[i]);
+            CHECK((cmp[i] < 0) == (xs[i] < ys[i]));
+            CHECK((cmp[i] == 0) == (xs[i] == ys[i]));
+        }
+    }
+
+    SUBCASE("Many elements") {
+        vector<Longnum> many;
+        for (int i{-100}; i < 100; i++) {
+            many.push_back(Longnum(i) / 3);
+        }
+        LongnumArray a(many, 1, 1);
+        auto squares{(a * a).to_vector()};
+        for (size_t i{0}; i < many.size(); i++) {
+            auto x{many[i]};
+            x.set_precision(Longnum::digit_bits);
+            CHECK(squares[i] == (x * x));
+        }
+    }
+
+    SUBCASE("Layout mismatch") {
+        LongnumArray a(xs, 2, 2);
+        LongnumArray b(xs, 1, 2);
+        CHECK_THROWS(a + b);
+        CHECK_THROWS(LongnumArray(3, 0, 0));
+    }
+}
@@ -0,0 +1,96 @@
+#include "doctest.h"
+
+#include "longnum_gcd.hpp"
+
+using namespace std;
+using namespace ln;
+using namespace lits;
+
+static Longnum power(Longnum base, unsigned exp) {
+    Longnum res(1);
+    for (unsigned i{0}; i < exp; i++) {
+        res *= base;
+    }
+    return res;
+}
+
+// Plain Euclidean algorithm on non-negative integers.
+static Longnum euclid(Longnum a, Longnum b) {
+    while (b.sign() != 0) {
+        a %= b;
+        swap(a, b);
+    }
+    return a;
+}
+
+static void check_xgcd(const Longnum &a, const Longnum &b) {
+    auto [g, s, t] = xgcd(a, b);
+    CHECK(g == gcd(a, b));
+    CHECK(a * s + b * t == g);
+}
+
+TEST_CASE("Greatest common divisor") {
+    Longnum a{power(3, 150) * power(5, 40) * 7};
+    Longnum b{power(3, 90) * power(5, 70) * 11};
+    Longnum common{power(3, 90) * power(5, 40)};
+
+    SUBCASE("Small and trivial values") {
+        CHECK(gcd(0, 0).sign() == 0);
+        CHECK(gcd(0, 12) == 12);
+        CHECK(gcd(12, 0) == 12);
+        CHECK(gcd(12, 18) == 6);
+        CHECK(gcd(-12, 18) == 6);
+        CHECK(gcd(12, -18) == 6);
+        CHECK(gcd(17, 5) == 1);
+        CHECK(gcd(12.75_longnum, 18.5_longnum) == 6);
+        CHECK(gcd(12, 18).get_precision() == 0);
+    }
+
+    SUBCASE("Large values") {
+        CHECK(gcd(a, b) == common);
+        CHECK(gcd(b, a) == common);
+        CHECK(gcd(a, -b) == common);
+        CHECK(gcd(a, a) == a);
+        CHECK(gcd(a + 1, a) == 1);
+
+        Longnum c{power(7, 200) + 1};
+        Longnum d{power(11, 130) - 3};
+        CHECK(gcd(c, d) == euclid(c, d));
+        CHECK(gcd(c * d, d * 12345) == d * euclid(c, 12345));
+    }
+
+    SUBCASE("Consecutive Fibonacci numbers") {
+        Longnum f0(0);
+        Longnum f1(1);
+        for (int i{0}; i < 1000; i++) {
+            f0 += f1;
+            swap(f0, f1);
+        }
+        CHECK(gcd(f1, f0) == 1);
+        check_xgcd(f1, f0);
+    }
+
+    SUBCASE("Extended") {
+        check_xgcd(0, 0);
+        check_xgcd(0, 5);
+        check_xgcd(5, 0);
+        check_xgcd(240, 46);
+        check_xgcd(-240, 46);
+        check_xgcd(240, -46);
+        check_xgcd(-240, -46);
+        check_xgcd(a, b);
+        check_xgcd(b, a);
+        check_xgcd(-a, b);
+        check_xgcd(a, a);
+        check_xgcd(power(2, 300) + 1, power(3, 170) - 2);
+    }
+
+    SUBCASE("Least common multiple") {
+        CHECK(lcm(0, 5).sign() == 0);
+        CHECK(lcm(5, 0).sign() == 0);
+        CHECK(lcm(4, 6) == 12);
+        CHECK(lcm(-4, 6) == 12);
+        CHECK(lcm(4, -6) == 12);
+        CHECK(lcm(a, b) == a * b / common);
+    }
+}
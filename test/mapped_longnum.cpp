@@ -0,0 +1,142 @@
+#include "doctest.h"
+
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+
+#include "mapped_longnum.hpp"
+
+using namespace std;
+using namespace ln;
+using namespace lits;
+
+static Longnum power(Longnum base, unsigned exp) {
+    Longnum res(1);
+    for (unsigned i{0}; i < exp; i++) {
+        res *= base;
+    }
+    return res;
+}
+
+TEST_CASE("Memory-mapped numbers") {
+    auto dir{filesystem::temp_directory_path()};
+
+    Longnum a{power(3, 400) + power(2, 100)};
+    Longnum b{-power(7, 250) - 1};
+    a.set_precision(70);
+    b.set_precision(40);
+
+    SUBCASE("Conversion") {
+        MappedLongnum zero(dir);
+        CHECK(zero.size() == 0);
+        CHECK(zero.sign() == 0);
+        CHECK(zero.to_longnum().sign() == 0);
+
+        MappedLongnum x(a, dir);
+        CHECK(x.sign() == 1);
+        CHECK(x.get_precision() == 70);
+        CHECK(x.size() == a.digits.size());
+        CHECK(x.to_longnum() == a);
+
+        MappedLongnum y(b, dir);
+        CHECK(y.sign() == -1);
+        CHECK(y.to_longnum() == b);
+
+        MappedLongnum z(move(y));
+        CHECK(z.to_longnum() == b);
+        z = MappedLongnum(a, dir);
+        CHECK(z.to_longnum() == a);
+    }
+
+    SUBCASE("Multiplication") {
+        MappedLongnum x(a, dir);
+        MappedLongnum y(b, dir);
+
+        Longnum expected{a * b};
+        expected.set_precision(110);
+
+        for (size_t block : {1, 2, 3, 7, 16, 1000}) {
+            auto prod{MappedLongnum::multiply(x, y, dir, block)};
+            CHECK(prod.get_precision() == 110);
+            CHECK(prod.to_longnum() == expected);
+        }
+        CHECK(MappedLongnum::multiply(x, x, dir).to_longnum() == a * a);
+
+        MappedLongnum zero(dir);
+        CHECK(MappedLongnum::multiply(x, zero, dir).sign() == 0);
+        CHECK_THROWS(MappedLongnum::multiply(x, y, dir, 0));
+
+        // Several column batches, carries through every coefficient
+        Longnum c{power(3, 40000)};
+        Longnum ones{(Longnum(1) << 70000) - 1};
+        MappedLongnum mc(c, dir);
+        MappedLongnum mo(ones, dir);
+        for (size_t block : {64, 4096}) {
+            CHECK(MappedLongnum::multiply(mc, mo, dir, block).to_longnum() ==
+                  c * ones);
+            CHECK(MappedLongnum::multiply(mo, mo, dir, block).to_longnum() ==
+                  ones * ones);
+        }
+    }
+
+    SUBCASE("Addition and subtraction") {
+        // Results must match Longnum's. Precision too, unless an operand is
+        // 0, as Longnum keeps the precision of the other one then. Zero
+        // results are only checked for sign
+        auto same{[](const MappedLongnum &x, const Longnum &y, bool exact) {
+            if (y.sign() == 0) {
+                return x.sign() == 0;
+            }
+            return x.to_longnum() == y && x.sign() == y.sign() &&
+                   (!exact || x.get_precision() == y.get_precision());
+        }};
+
+        const Longnum values[]{Longnum(0),
+                               Longnum(0, 40),
+                               a,
+                               b,
+                               -a,
+                               Longnum(1) << 3000,
+                               (Longnum(1) << 3000).set_precision(-20),
+                               Longnum(-1234.5625),
+                               Longnum(48).set_precision(-4)};
+        bool ok{true};
+        for (const auto &u : values) {
+            for (const auto &v : values) {
+                MappedLongnum x(u, dir);
+                MappedLongnum y(v, dir);
+                const bool exact{u.sign() != 0 && v.sign() != 0};
+                ok = ok && same(MappedLongnum::add(x, y, dir), u + v, exact);
+                ok = ok &&
+                     same(MappedLongnum::subtract(x, y, dir), u - v, exact);
+            }
+        }
+        CHECK(ok);
+    }
+
+    SUBCASE("Serialization") {
+        for (const auto &x : {a, b, Longnum(0, 7), power(7, 60000)}) {
+            stringstream ss;
+            x.write_binary(ss);
+            MappedLongnum y(ss, dir);
+            CHECK(y.to_longnum() == x);
+            CHECK(y.get_precision() == x.get_precision());
+            CHECK(y.sign() == x.sign());
+
+            stringstream back;
+            y.write_binary(back);
+            auto z{Longnum::read_binary(back)};
+            CHECK(z == x);
+            CHECK(z.get_precision() == x.get_precision());
+        }
+
+        istringstream truncated(
+            string("\0\0\0\0\0\x05\0\0\0\0\0\0\0\x01", 14));
+        CHECK_THROWS_AS(MappedLongnum(truncated, dir), invalid_argument);
+        istringstream huge_size(
+            string("\0\0\0\0\0\xff\xff\xff\xff\xff\xff\xff\x7f\x01", 14));
+        CHECK_THROWS_AS(MappedLongnum(huge_size, dir), invalid_argument);
+        istringstream bad_sign(string("\xff\0\0\0\0\0\0\0\0\0\0\0\0", 13));
+        CHECK_THROWS_AS(MappedLongnum(bad_sign, dir), invalid_argument);
+    }
+}
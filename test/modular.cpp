@@ -0,0 +1,64 @@
+#include "doctest.h"
+
+#include "longnum_modular.hpp"
+
+using namespace std;
+using namespace ln;
+using namespace lits;
+
+static Longnum power(Longnum base, unsigned exp) {
+    Longnum res(1);
+    for (unsigned i{0}; i < exp; i++) {
+        res *= base;
+    }
+    return res;
+}
+
+TEST_CASE("Modular arithmetic") {
+    // 2^127 - 1 is a prime
+    Longnum p{power(2, 127) - 1};
+    ModContext ctx(p);
+
+    SUBCASE("Construction") {
+        CHECK(ctx.modulus() == p);
+        CHECK_THROWS(ModContext(Longnum(10)));
+        CHECK_THROWS(ModContext(Longnum(1)));
+        CHECK_THROWS(ModContext(Longnum(-7)));
+    }
+
+    SUBCASE("Reduction and multiplication") {
+        Longnum a{power(3, 100)};
+        Longnum b{power(7, 60) + 12345};
+
+        CHECK(ctx.reduce(a) == a % p);
+        CHECK(ctx.reduce(-a) == (-a) % p);
+        CHECK(ctx.mulmod(a, b) == (a * b) % p);
+        CHECK(ctx.mulmod(-a, b) == (-a * b) % p);
+        CHECK(ctx.mulmod(0, b).sign() == 0);
+    }
+
+    SUBCASE("Exponentiation") {
+        CHECK(ctx.powmod(2, p - 1) == 1);
+        CHECK(ctx.powmod(3, p - 1) == 1);
+        CHECK(ctx.powmod(5, 0) == 1);
+        CHECK(ctx.powmod(5, 3) == 125);
+
+        ModContext small(1000003);
+        Longnum expected(1);
+        for (int i{0}; i < 1000; i++) {
+            expected = expected * 12345 % 1000003;
+        }
+        CHECK(small.powmod(12345, 1000) == expected);
+        CHECK(small.mulmod(small.powmod(12345, -1000), expected) == 1);
+    }
+
+    SUBCASE("Inverse") {
+        Longnum a{power(3, 50)};
+        CHECK(ctx.mulmod(ctx.inverse(a), a) == 1);
+
+        ModContext composite(15);
+        CHECK(composite.inverse(2) == 8);
+        CHECK_THROWS(composite.inverse(6));
+        CHECK_THROWS(composite.inverse(0));
+    }
+}
@@ -263,6 +263,69 @@ TEST_CASE("Multiplication") {
         CHECK((big1 * big2).to_string(1) ==
                 "1000000000000000000000000000000000000.0");
     }
+    SUBCASE("Truncated products") {
+        auto reference = [](const Longnum &a, const Longnum &b,
+                            Longnum::Precision prec) {
+            Longnum res;
+            res.digits = kernels::mul(a.digits, b.digits);
+            res.precision = a.precision + b.precision;
+            res.negative = a.sign() * b.sign() < 0;
+            res.set_precision(prec);
+            return res;
+        };
+
+        Longnum a(1, 1000), b(-1, 700), c(3, 300);
+        a /= 7;
+        b /= 13;
+        c /= 11;
+        Longnum ones(1, 2000);
+        ones /= 3;
+        ones += ones;
+
+        for (auto &x : {a, b, c, ones}) {
+            for (auto &y : {a, b, c, ones}) {
+                CHECK(x * y == reference(x, y, max(x.precision, y.precision)));
+
+                auto high{x};
+                high.mul_high(y, 500);
+                auto exact{reference(x, y, 500)};
+                CHECK(high.abs_compare(exact) <= 0);
+                CHECK((exact - high).abs_compare(Longnum(1, 500) >> 500) <= 0);
+            }
+        }
+    }
+
+    SUBCASE("Blocked products") {
+        // (2^(32n) - 1) * (2^(32m) - 1) carries through every limb
+        auto ones{[](size_t n) {
+            return kernels::Digits(n, numeric_limits<Longnum::Digit>::max());
+        }};
+        for (size_t n : {1, 3, 4, 7, 1025}) {
+            for (size_t m : {1, 2, 5, 1023, 2100}) {
+                kernels::Digits expected(n + m, 0);
+                expected[0] = 1;
+                expected[min(n, m)] = numeric_limits<Longnum::Digit>::max();
+                for (size_t k{min(n, m) + 1}; k < n + m; k++) {
+                    expected[k] = numeric_limits<Longnum::Digit>::max();
+                }
+                expected[max(n, m)] -= 1;
+                CHECK(kernels::mul(ones(n), ones(m)) == expected);
+            }
+        }
+
+        kernels::Digits a(2051), b(1500);
+        for (size_t i{0}; i < a.size(); i++) {
+            a[i] = static_cast<Longnum::Digit>(i * 2654435761u + 12345);
+        }
+        for (size_t i{0}; i < b.size(); i++) {
+            b[i] = i % 9 == 0 ? 0 : static_cast<Longnum::Digit>(~i * 40503u);
+        }
+        const auto product{kernels::mul(a, b)};
+        CHECK(product == kernels::mul(b, a));
+        const auto [q, r] = kernels::div_mod(product, b);
+        CHECK(q == a);
+        CHECK(r.empty());
+    }
 }
 
 TEST_CASE("Division and Modulo") {
@@ -341,9 +404,453 @@ TEST_CASE("Division and Modulo") {
         }
     }
 
+    SUBCASE("Division to a target precision") {
+        CHECK(div(Longnum(1), Longnum(3), 64) == Longnum(1, 64) / 3);
+        CHECK(div(Longnum(1), Longnum(3), 64).get_precision() == 64);
+        CHECK(div(Longnum(-1), Longnum(3), 4).to_string(4) == "-0.3125");
+        CHECK(div(Longnum(7), Longnum(-2), 0).to_string(0) == "-3");
+        CHECK(div(Longnum(1), Longnum(1000), 5).sign() == 0);
+        CHECK_THROWS(div(Longnum(1), Longnum(0), 5));
+
+        Longnum tiny(1, 50);
+        tiny.set_precision(50);
+        tiny.digits = {1};
+        Longnum big(1);
+        for (int i{0}; i < 100; i++) {
+            big *= 2;
+        }
+        CHECK(big / tiny == big * big / Longnum(1 << 25) / Longnum(1 << 25));
+        CHECK((big / tiny).bits_in_absolute_value() == 151 + 50);
+    }
+
     SUBCASE("Identity operations") {
         Longnum a(123, 142);
         CHECK((a / a).to_string(1) == "1.0");
         CHECK((a % a).to_string(1) == "0.0");
     }
 }
+
+TEST_CASE("Powers") {
+    // Exact power by repeated multiplication.
+    auto naive{[](const Longnum &x, unsigned n) {
+        Longnum res(1);
+        for (unsigned i{0}; i < n; i++) {
+            res.mul_to_precision(x, res.get_precision() + x.get_precision(),
+                                 true);
+        }
+        return res;
+    }};
+
+    SUBCASE("Exact") {
+        CHECK(pow(Longnum(7), 0) == 1);
+        CHECK(pow(Longnum(0), 5).sign() == 0);
+        CHECK(pow(Longnum(-3), 3) == -27);
+        CHECK(pow(Longnum(-3), 4) == 81);
+
+        Longnum x(1.5);
+        auto p{pow(x, 10)};
+        CHECK(p.get_precision() == 10 * x.get_precision());
+        CHECK(p == naive(x, 10));
+
+        Longnum y(-12345.6789);
+        for (unsigned n : {1u, 2u, 3u, 7u, 31u, 100u, 257u}) {
+            CHECK(pow(y, n) == naive(y, n));
+        }
+    }
+
+    SUBCASE("Powers of two are shifts") {
+        CHECK(pow(Longnum(16), 250) == Longnum(1) << 1000);
+        CHECK(pow(Longnum(-2), 3) == -8);
+        CHECK(pow(Longnum(0.25), 3) == Longnum(1.0 / 64));
+        CHECK(pow(Longnum(0.25), 3).get_precision() ==
+              3 * Longnum(0.25).get_precision());
+
+        CHECK(pow(Longnum(0.5), 10, 8).sign() == 0);
+        CHECK(pow(Longnum(0.5), 8, 8) == Longnum(1.0 / 256));
+        CHECK(pow(Longnum(0.5), -3, 8) == 8);
+        CHECK(pow(Longnum(-4), 3, 5) == -64);
+        CHECK(pow(Longnum(-4), 3, 5).get_precision() == 5);
+    }
+
+    SUBCASE("Negative precision") {
+        const auto x{Longnum(48).set_precision(-4)};
+        CHECK(pow(x, 3) == 110592);
+        CHECK(pow(x, 3).get_precision() == -12);
+        CHECK(pow(x, 3) == naive(x, 3));
+
+        const auto y{Longnum(-32).set_precision(-4)};
+        CHECK(pow(y, 5) == naive(y, 5));
+        CHECK(pow(y, 5).get_precision() == -20);
+
+        CHECK_THROWS(pow(Longnum(48).set_precision(-70000), 70000));
+    }
+
+    SUBCASE("Working precision") {
+        Longnum x(1, 300);
+        x /= 3;
+        x += 1;
+
+        // Squarings truncate differently from repeated multiplication, so
+        // compare with the exact power. Truncation errors grow with the
+        // power, about n * x^n units in the last place.
+        for (int64_t n : {1, 2, 5, 64, 100}) {
+            Longnum exact{pow(x, static_cast<uint64_t>(n))};
+            exact.set_precision(200);
+            auto approx{pow(x, n, 200)};
+            CHECK(approx.get_precision() == 200);
+            CHECK(approx <= exact);
+            CHECK(exact - approx < (Longnum(1, 200) >> 140));
+        }
+
+        CHECK(pow(Longnum(3), 0, 10) == 1);
+        CHECK(pow(Longnum(3), 0, 10).get_precision() == 10);
+        CHECK(pow(Longnum(2.5), -2, 64) == div(Longnum(1), Longnum(6.25), 64));
+        CHECK_THROWS(pow(Longnum(0), -1, 10));
+    }
+
+    SUBCASE("Negative exponents") {
+        // The result r is 1 / x^n truncated, so r * x^n <= 1 and the next
+        // number after r overshoots. Scaled to integers, both products are
+        // exact.
+        auto abs{[](const Longnum &v) { return v.sign() < 0 ? -v : v; }};
+        auto check{[abs](const Longnum &x, uint64_t n, int32_t prec) {
+            auto r{pow(x, -static_cast<int64_t>(n), prec)};
+            CHECK(r.get_precision() == prec);
+            const auto x_bits{x.get_precision() * static_cast<int64_t>(n)};
+            Longnum scale(1);
+            scale <<= static_cast<size_t>(prec + x_bits);
+            Longnum power{ldexp(pow(abs(x), n), x_bits)};
+            Longnum digits{abs(ldexp(r, prec))};
+            CHECK(digits * power <= scale);
+            CHECK((digits + 1) * power > scale);
+        }};
+
+        const auto thousandth{div(Longnum(1), Longnum(1000), 64)};
+        check(thousandth, 10, 64);
+        CHECK(pow(thousandth, -10, 64) > Longnum(1) << 99);
+        const auto third{div(Longnum(1), Longnum(3), 64)};
+        check(third, 30, 64);
+        CHECK(abs(pow(third, -30, 64) - 205891132094649) < 1);
+        check(-third, 7, 100);
+        CHECK(pow(-third, -7, 100) < 0);
+        check(Longnum(-3), 5, 20);
+        check(Longnum(1000.5), 3, 10);
+    }
+
+    SUBCASE("Constant evaluation") {
+        constexpr auto p{bake<[] { return pow(Longnum(3), 40); }>()};
+        CHECK(Longnum(p) == naive(Longnum(3), 40));
+    }
+}
+
+TEST_CASE("Temporary operands") {
+    Longnum a(1, 64);
+    for (int i{0}; i < 50; i++) {
+        a *= 7;
+    }
+    a /= 3;
+    Longnum b{-a / 5};
+    Longnum c(12.375);
+
+    SUBCASE("Same results as copies") {
+        CHECK(Longnum{a} + b == a + b);
+        CHECK(a + Longnum{b} == a + b);
+        CHECK(Longnum{a} + Longnum{b} == a + b);
+        CHECK(Longnum{a} - c == a - c);
+        CHECK(c - Longnum{a} == c - a);
+        CHECK(Longnum{c} - Longnum{a} == c - a);
+        CHECK((c - Longnum{a}).get_precision() == 64);
+        CHECK(Longnum{a} * c == a * c);
+        CHECK(c * Longnum{a} == a * c);
+        CHECK(Longnum{a} * Longnum{b} == a * b);
+        CHECK(-Longnum{a} == -a);
+        CHECK((a - Longnum{a}).sign() == 0);
+        CHECK(a - 1 == a - Longnum(1));
+        CHECK(1 + a == a + 1);
+    }
+
+    SUBCASE("Zero products keep the left precision") {
+        Longnum x(3, 40);
+        Longnum zero{};
+        CHECK((x * Longnum{}).get_precision() == (x * zero).get_precision());
+        CHECK((x * Longnum{}).get_precision() == 40);
+        CHECK((Longnum{x} * Longnum{}).get_precision() == 40);
+        CHECK((zero * Longnum{x}).get_precision() == 0);
+        CHECK((Longnum{} * Longnum{x}).get_precision() == 0);
+    }
+
+    SUBCASE("Limbs are reused") {
+        Longnum x{a + 1};
+        const auto *buffer{x.digits.buffer};
+        auto sum{std::move(x) + c};
+        CHECK(sum.digits.buffer == buffer);
+
+        Longnum y{a + 1};
+        buffer = y.digits.buffer;
+        auto diff{c - std::move(y)};
+        CHECK(diff.digits.buffer == buffer);
+        CHECK(diff == c - a - 1);
+    }
+
+    SUBCASE("Chains") {
+        Longnum n4(4, 64), n2(2, 64), n1(1, 64);
+        Longnum d(8, 64);
+        auto res{n4 / a - n2 / b - n1 / c - n1 / d};
+        Longnum expected{n4 / a};
+        expected -= n2 / b;
+        expected -= n1 / c;
+        expected -= n1 / d;
+        CHECK(res == expected);
+    }
+}
+
+TEST_CASE("Bit manipulation") {
+    SUBCASE("Scaling") {
+        Longnum x(3.25);
+        CHECK(ldexp(x, 4) == 52);
+        CHECK(ldexp(x, -3) == Longnum(0.40625));
+        CHECK(ldexp(x, -3).get_precision() == x.get_precision() + 3);
+        CHECK(ldexp(Longnum(-5), 100) == Longnum(-5) * pow(Longnum(2), 100u));
+        CHECK(ldexp(Longnum(0), 7).sign() == 0);
+        CHECK_THROWS(ldexp(x, numeric_limits<int64_t>::min()));
+        CHECK_THROWS(ldexp(Longnum(1, numeric_limits<int32_t>::max()), -1));
+
+        CHECK((Longnum(5) << 3) == 40);
+        CHECK((Longnum(-40) >> 3) == -5);
+        CHECK((Longnum(-41) >> 3) == -5);
+        CHECK((x >> 1).get_precision() == x.get_precision());
+    }
+
+    SUBCASE("Bitwise operations") {
+        CHECK((Longnum(12) & Longnum(10)) == 8);
+        CHECK((Longnum(12) | Longnum(10)) == 14);
+        CHECK((Longnum(12) ^ Longnum(10)) == 6);
+        CHECK((Longnum(-12) & Longnum(10)) == (-12 & 10));
+        CHECK((Longnum(-12) | Longnum(10)) == (-12 | 10));
+        CHECK((Longnum(-12) ^ Longnum(-10)) == (-12 ^ -10));
+        CHECK((Longnum(-1) & Longnum(-1)) == -1);
+        CHECK((Longnum(5) ^ Longnum(5)).sign() == 0);
+
+        // Fraction bits take part too: 0.75 = 0.11, 2.5 = 10.1
+        CHECK((Longnum(0.75) | Longnum(2.5)) == Longnum(2.75));
+        CHECK((Longnum(0.75) & Longnum(2.5)) == Longnum(0.5));
+        CHECK((Longnum(-0.25) & Longnum(1.75)) == Longnum(1.75));
+
+        Longnum big{pow(Longnum(3), 200u)};
+        Longnum mask{pow(Longnum(2), 64u) - 1};
+        CHECK((big & mask) == big % pow(Longnum(2), 64u));
+        CHECK(((big | mask) ^ mask) == big - (big & mask));
+
+        Longnum y(77);
+        y &= Longnum(-8);
+        CHECK(y == 72);
+        y |= Longnum(3);
+        CHECK(y == 75);
+        y ^= Longnum(1);
+        CHECK(y == 74);
+    }
+
+    SUBCASE("Bit queries") {
+        CHECK(Longnum(0).popcount() == 0);
+        CHECK(Longnum(255).popcount() == 8);
+        CHECK(Longnum(-255).popcount() == 8);
+        CHECK((pow(Longnum(2), 100u) - 1).popcount() == 100);
+
+        CHECK(Longnum(40).countr_zero() == 3);
+        CHECK(Longnum(-40).countr_zero() == 3);
+        CHECK(Longnum(0.375).countr_zero() == -3);
+        CHECK(pow(Longnum(2), 100u).countr_zero() == 100);
+        CHECK_THROWS(Longnum(0).countr_zero());
+
+        for (int v : {0, 1, 6, -1, -6, -40, 12345, -12345}) {
+            bool same{true};
+            for (int i{0}; i < 31; i++) {
+                same = same && Longnum(v).test_bit(i) == (((v >> i) & 1) != 0);
+            }
+            CHECK(same);
+        }
+        CHECK(Longnum(-1).test_bit(1000));
+        CHECK(!Longnum(1).test_bit(1000));
+        CHECK(Longnum(0.25).test_bit(-2));
+        CHECK(!Longnum(0.25).test_bit(-1));
+        // -0.25 is ...111.11
+        CHECK(Longnum(-0.25).test_bit(-1));
+        CHECK(Longnum(-0.25).test_bit(-2));
+        CHECK(!Longnum(-0.25).test_bit(-3));
+    }
+
+    SUBCASE("Constant evaluation") {
+        static_assert((Longnum(12) & Longnum(-3)) == 12);
+        static_assert(ldexp(Longnum(3), 2) == 12);
+        static_assert(Longnum(96).countr_zero() == 5);
+    }
+}
+
+TEST_CASE("Integral operands") {
+    // Results must match the ones with the operand converted to Longnum
+    auto same{[](const Longnum &a, const Longnum &b) {
+        return a == b && a.sign() == b.sign() &&
+               a.get_precision() == b.get_precision();
+    }};
+
+    Longnum big(1);
+    big <<= 100;
+    big += Longnum(0.75);
+    const Longnum values[]{Longnum(0),        Longnum(0, 40),
+                           Longnum(1),        Longnum(-7),
+                           Longnum(12345, 3), Longnum(-1234.5625),
+                           Longnum(0.375),    Longnum(48).set_precision(-4),
+                           big,               -big,
+                           Longnum(32).set_precision(-5)};
+    const long long operands[]{1,  -1,         3,          -3,
+                               7,  4294967295, 4294967296, -1000000000000,
+                               40, -48};
+
+    SUBCASE("Arithmetic") {
+        bool ok{true};
+        for (const auto &a : values) {
+            for (auto v : operands) {
+                const Longnum b(v);
+                ok = ok && same(a + v, a + b) && same(v + a, b + a);
+                ok = ok && same(a - v, a - b) && same(v - a, b - a);
+                ok = ok && same(a * v, a * b) && same(v * a, b * a);
+                ok = ok && same(a / v, a / b) && same(a % v, a % b);
+                if (a.sign() != 0) {
+                    ok = ok && same(v / a, b / a) && same(v % a, b % a);
+                }
+            }
+        }
+        CHECK(ok);
+
+        Longnum x(5);
+        x += 0;
+        x -= 0u;
+        CHECK(same(x, Longnum(5)));
+        x *= static_cast<unsigned char>(200);
+        CHECK(x == 1000);
+        x /= -8;
+        CHECK(x == -125);
+        x %= 7;
+        CHECK(x == 1);
+        CHECK(same(Longnum(3) * 0, Longnum(3) * Longnum(0)));
+        for (const auto &a : values) {
+            CHECK(same(0 * a, Longnum(0) * a));
+            CHECK(same(a * 0, a * Longnum(0)));
+        }
+
+        // Below the operand, with negative precision
+        const auto small{Longnum(48).set_precision(-4)};
+        CHECK(same(small % 100, Longnum(48)));
+        CHECK(same(small % Longnum(100), Longnum(48)));
+        CHECK_THROWS(Longnum(1) / 0);
+        CHECK_THROWS(Longnum(1) % 0);
+
+        // Extreme values of the operand
+        const auto min{numeric_limits<long long>::min()};
+        const auto max{numeric_limits<unsigned long long>::max()};
+        CHECK(same(Longnum(1) + min, Longnum(1) + Longnum(min)));
+        CHECK(same(big * max, big * Longnum(max)));
+        CHECK(same(-big / max, -big / Longnum(max)));
+    }
+
+    SUBCASE("Comparison") {
+        bool ok{true};
+        for (const auto &a : values) {
+            for (auto v : operands) {
+                ok = ok && (a <=> v) == (a <=> Longnum(v));
+                ok = ok && (a == v) == (a == Longnum(v));
+            }
+        }
+        CHECK(ok);
+
+        CHECK(Longnum(0, 40) == 0);
+        CHECK(Longnum(-0.5) < 0);
+        CHECK(0 < Longnum(0.5));
+        CHECK(Longnum(1.5) > 1);
+        CHECK(Longnum(1.5) < 2u);
+        CHECK(Longnum(-1.5) < -1);
+        CHECK(Longnum(-1.5) > -2);
+        CHECK(big > numeric_limits<unsigned long long>::max());
+        CHECK(Longnum(numeric_limits<long long>::min()) ==
+              numeric_limits<long long>::min());
+    }
+
+    SUBCASE("Constant evaluation") {
+        static_assert(Longnum(6) * 7 == 42);
+        static_assert(100 - Longnum(58) == 42);
+        static_assert(Longnum(85) / 2 == 42);
+        static_assert(Longnum(-1) % 43 == 42);
+    }
+}
+
+TEST_CASE("Working precision") {
+    const Longnum a(0.75);
+    const Longnum b(0.125);
+    const Longnum two(2);
+    CHECK(WorkingPrecision::current() == nullptr);
+
+    SUBCASE("Truncation") {
+        WorkingPrecision wp(3);
+        CHECK(WorkingPrecision::current() == &wp);
+        CHECK(wp.get_precision() == 3);
+        CHECK(wp.get_rounding() == Rounding::truncate);
+
+        CHECK((a * a) == Longnum(0.5));
+        CHECK((a * a).get_precision() == 3);
+        CHECK((two / 3) == Longnum(0.625));
+        CHECK((two / Longnum(3)) == Longnum(0.625));
+        CHECK((two / Longnum(3)).get_precision() == 3);
+        CHECK((Longnum(1) + Longnum(2)).get_precision() == 3);
+        CHECK((-two / 3) == -two / Longnum(3));
+
+        Longnum x(1, 40);
+        x -= Longnum(1, 40) >> 40;
+        CHECK(x == Longnum(0.875));
+        CHECK(x.get_precision() == 3);
+    }
+
+    SUBCASE("Rounding to nearest") {
+        WorkingPrecision wp(1, Rounding::nearest);
+        CHECK(a + b == 1);
+        CHECK(-a - b == -1);
+        CHECK(a + 1 == 2);
+        CHECK((a * 3) == Longnum(2.5));
+        CHECK((a + b).get_precision() == 1);
+        {
+            WorkingPrecision inner(4, Rounding::nearest);
+            CHECK(WorkingPrecision::current() == &inner);
+            CHECK(two / 3 == Longnum(0.6875));
+            CHECK(-two / Longnum(3) == Longnum(-0.6875));
+            CHECK(a * a == Longnum(0.5625));
+        }
+        CHECK(WorkingPrecision::current() == &wp);
+
+        Longnum x(0.25);
+        x *= Longnum(0.75);
+        CHECK(x == 0);
+    }
+
+    SUBCASE("Exact operations") {
+        const Longnum c(-7.5);
+        const auto expected{c.div_mod(Longnum(0.375))};
+        WorkingPrecision wp(0);
+        const auto [q, r] = c.div_mod(Longnum(0.375));
+        CHECK(q == expected.first);
+        CHECK(q.get_precision() == expected.first.get_precision());
+        CHECK(r == expected.second);
+        CHECK(c % Longnum(0.375) == expected.second);
+        CHECK(div(Longnum(1), Longnum(3), 10).get_precision() == 10);
+        {
+            WorkingPrecision::Suspend exact{};
+            CHECK(WorkingPrecision::current() == nullptr);
+            CHECK(a * a == Longnum(0.5625));
+        }
+        CHECK(WorkingPrecision::current() == &wp);
+        static_assert((Longnum(1) >> 2) * (Longnum(3) >> 2) ==
+                      Longnum(3) >> 4);
+    }
+
+    CHECK(WorkingPrecision::current() == nullptr);
+    CHECK_THROWS(WorkingPrecision(numeric_limits<Longnum::Precision>::max(),
+                                  Rounding::nearest));
+}
@@ -0,0 +1,217 @@
+#include "doctest.h"
+
+#include "longnum.hpp"
+
+#include <sstream>
+#include <string>
+
+using namespace std;
+using namespace ln;
+
+TEST_CASE("Decimal output") {
+    SUBCASE("Same as to_string") {
+        Longnum a(-1234.5625);
+
+        for (uint32_t fp : {0u, 1u, 5u, 20u}) {
+            ostringstream os;
+            a.write_decimal(os, fp);
+            CHECK(os.str() == a.to_string(fp));
+        }
+
+        CHECK(a.to_string(3) == "-1234.562");
+        CHECK(Longnum(0).to_string(0) == "0");
+        CHECK(Longnum(-1, 10).to_string(0) == "-1");
+    }
+
+    SUBCASE("Stream operator") {
+        ostringstream os;
+        os.precision(2);
+        os << Longnum(42) << ' ' << Longnum(-0.25);
+        CHECK(os.str() == "42.00 -0.25");
+    }
+
+    SUBCASE("Huge numbers") {
+        Longnum ten(10);
+        Longnum big(1);
+        for (int i{0}; i < 1000; i++) {
+            big *= ten;
+        }
+
+        string expected(1001, '0');
+        expected[0] = '1';
+        CHECK(big.to_string(0) == expected);
+
+        big += 7;
+        expected.back() = '7';
+        CHECK(big.to_string(0) == expected);
+
+        big -= 8;
+        CHECK(big.to_string(2) == string(1000, '9') + ".00");
+    }
+
+    SUBCASE("Long fractions") {
+        Longnum third(1, 4000);
+        third /= 3;
+
+        auto str{third.to_string(1000)};
+        CHECK(str == "0." + string(1000, '3'));
+    }
+}
+
+TEST_CASE("Decimal input") {
+    SUBCASE("Small numbers") {
+        CHECK(Longnum::from_string("0") == 0);
+        CHECK(Longnum::from_string("42") == 42);
+        CHECK(Longnum::from_string("-42") == -42);
+        CHECK(Longnum::from_string("+42") == 42);
+        CHECK(Longnum::from_string("-0").sign() == 0);
+        CHECK(Longnum::from_string("-1234.5625", 8) == Longnum(-1234.5625));
+        CHECK(Longnum::from_string("0.1", 4).to_string(4) == "0.0625");
+        CHECK(Longnum::from_string("1.75").get_precision() == 0);
+        CHECK(Longnum::from_string("1.75") == 1);
+        CHECK(Longnum::from_string("1.75", 10).get_precision() == 10);
+    }
+
+    SUBCASE("Round trip") {
+        Longnum big(1);
+        for (int i{0}; i < 1000; i++) {
+            big *= 7;
+        }
+        big = -big;
+        CHECK(Longnum::from_string(big.to_string(0)) == big);
+
+        auto str{"0." + string(1000, '3')};
+        auto third{Longnum::from_string(str, 3400)};
+        CHECK(third.to_string(999) == str.substr(0, 1001));
+        CHECK(Longnum::from_string("0.0009765625", 10).to_string(10) ==
+              "0.0009765625");
+    }
+
+    SUBCASE("Malformed strings") {
+        CHECK_THROWS(Longnum::from_string(""));
+        CHECK_THROWS(Longnum::from_string("-"));
+        CHECK_THROWS(Longnum::from_string(".5"));
+        CHECK_THROWS(Longnum::from_string("5."));
+        CHECK_THROWS(Longnum::from_string("1e5"));
+        CHECK_THROWS(Longnum::from_string("1.2.3"));
+        CHECK_THROWS(Longnum::from_string(" 1"));
+        CHECK_THROWS(Longnum::from_string("1", -1));
+    }
+}
+
+TEST_CASE("Power-of-two radixes") {
+    using R = Longnum::Radix;
+
+    SUBCASE("Output") {
+        CHECK(Longnum(0).to_string(R::base16) == "0");
+        CHECK(Longnum(255).to_string(R::base16) == "ff");
+        CHECK(Longnum(-255).to_string(R::base2) == "-11111111");
+        CHECK(Longnum(8).to_string(R::base8) == "10");
+        CHECK(Longnum(64).to_string(R::base4) == "1000");
+        CHECK(Longnum(1023).to_string(R::base32) == "vv");
+        CHECK(Longnum(-1234.5625).set_precision(4).to_string(R::base16) ==
+              "-4d2.9");
+        CHECK(Longnum(0.5).set_precision(3).to_string(R::base8) == "0.4");
+        // 5 bits for fraction take 2 octal digits
+        CHECK(Longnum(3, 5).to_string(R::base8) == "3.00");
+        CHECK(Longnum(48).set_precision(-4).to_string(R::base16) == "30");
+        const auto zero{Longnum(0).set_precision(-5)};
+        CHECK(zero.to_string(R::base16) == "0");
+        CHECK(zero.to_string(R::base2) == "0");
+    }
+
+    SUBCASE("Input") {
+        CHECK(Longnum::from_string("ff", R::base16) == 255);
+        CHECK(Longnum::from_string("FF", R::base16) == 255);
+        CHECK(Longnum::from_string("-4d2.9", R::base16) == Longnum(-1234.5625));
+        CHECK(Longnum::from_string("0.4", R::base8).get_precision() == 3);
+        CHECK(Longnum::from_string("vv", R::base32) == 1023);
+        CHECK(Longnum::from_string("-0", R::base2).sign() == 0);
+
+        CHECK_THROWS(Longnum::from_string("", R::base16));
+        CHECK_THROWS(Longnum::from_string("12", R::base2));
+        CHECK_THROWS(Longnum::from_string("g", R::base16));
+        CHECK_THROWS(Longnum::from_string("1.", R::base16));
+        CHECK_THROWS(Longnum::from_string(".1", R::base16));
+        CHECK_THROWS(Longnum::from_string("1.2.3", R::base16));
+    }
+
+    SUBCASE("Round trip") {
+        Longnum big(1, 100);
+        for (int i{0}; i < 500; i++) {
+            big *= 3;
+        }
+        big /= 7;
+        big.flip_sign();
+
+        for (auto radix :
+             {R::base2, R::base4, R::base8, R::base16, R::base32}) {
+            auto str{big.to_string(radix)};
+            CHECK(Longnum::from_string(str, radix) == big);
+            CHECK(Longnum::from_string(str, radix).to_string(radix) == str);
+        }
+
+        string hex(1000, 'f');
+        auto ones{Longnum::from_string(hex, R::base16)};
+        CHECK(ones.bits_in_absolute_value() == 4000);
+        CHECK(ones.to_string(R::base16) == hex);
+        CHECK(ones.to_string(R::base2) == string(4000, '1'));
+    }
+}
+
+TEST_CASE("Binary serialization") {
+    SUBCASE("Round trip") {
+        Longnum big(1);
+        for (int i{0}; i < 300; i++) {
+            big *= 7;
+        }
+        big.set_precision(77);
+
+        // Several blocks of output
+        Longnum huge{(Longnum(1) << 600000) - 3};
+        huge.set_precision(-5);
+
+        for (const Longnum &x : {Longnum(0), Longnum(0, 40), Longnum(255),
+                                 Longnum(-1234.5625), big, -big, huge}) {
+            stringstream ss;
+            x.write_binary(ss);
+            auto y{Longnum::read_binary(ss)};
+            CHECK(y == x);
+            CHECK(y.get_precision() == x.get_precision());
+            CHECK(y.sign() == x.sign());
+        }
+    }
+
+    SUBCASE("Layout") {
+        ostringstream os;
+        Longnum(-258, 3).write_binary(os);
+        // Sign, precision, 2 bytes of 258 * 2^3 = 0x810
+        string expected("\x01"
+                        "\x03\0\0\0"
+                        "\x02\0\0\0\0\0\0\0"
+                        "\x10\x08",
+                        15);
+        CHECK(os.str() == expected);
+    }
+
+    SUBCASE("Malformed data") {
+        istringstream empty("");
+        CHECK_THROWS(Longnum::read_binary(empty));
+
+        istringstream truncated(
+            string("\0\0\0\0\0\x05\0\0\0\0\0\0\0\x01", 14));
+        CHECK_THROWS(Longnum::read_binary(truncated));
+
+        istringstream bad_sign(
+            string("\x02\0\0\0\0\0\0\0\0\0\0\0\0", 13));
+        CHECK_THROWS(Longnum::read_binary(bad_sign));
+        istringstream high_sign(
+            string("\xff\0\0\0\0\0\0\0\0\0\0\0\0", 13));
+        CHECK_THROWS(Longnum::read_binary(high_sign));
+
+        // A corrupt size must not be trusted with an allocation
+        istringstream huge_size(
+            string("\0\0\0\0\0\xff\xff\xff\xff\xff\xff\xff\x7f\x01", 14));
+        CHECK_THROWS_AS(Longnum::read_binary(huge_size), invalid_argument);
+    }
+}
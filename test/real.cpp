@@ -0,0 +1,111 @@
+#include "doctest.h"
+
+#include "longnum_real.hpp"
+
+using namespace std;
+using namespace ln;
+using namespace lits;
+
+// Checks that `approx` is within 2^(-`prec`) of `exact`.
+static bool close(const Longnum &approx, const Longnum &exact,
+                  Longnum::Precision prec) {
+    Longnum diff{approx - exact};
+    if (diff.sign() < 0) {
+        diff = -diff;
+    }
+    return diff <= Longnum(1, prec) >> prec;
+}
+
+// sqrt(2) with an error of at most 2^(-prec), by bisection on integers.
+static Longnum sqrt2(Longnum::Precision prec) {
+    Longnum target(2);
+    target <<= 2 * prec;
+    Longnum lo(1);
+    lo <<= prec;
+    Longnum hi(2);
+    hi <<= prec;
+    while (hi - lo > 1) {
+        auto mid{(lo + hi) >> 1};
+        if (mid * mid <= target) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    lo.set_precision(prec);
+    lo >>= prec;
+    return lo;
+}
+
+TEST_CASE("Lazy reals") {
+    Longnum one_third(1, 2000);
+    one_third /= 3;
+
+    SUBCASE("Exact values") {
+        Real x{Longnum(-2.75)};
+        CHECK(x.approx(0) == Longnum(-2.75));
+        CHECK(x.approx(10).get_precision() >= 10);
+        CHECK(Real(5).approx(3) == 5);
+        CHECK(Real().approx(7).sign() == 0);
+        CHECK_THROWS(x.approx(-1));
+    }
+
+    SUBCASE("Arithmetic") {
+        Real a(Longnum(1.5));
+        Real b(-7);
+        CHECK((a + b).approx(20) == Longnum(-5.5));
+        CHECK((a - b).approx(20) == Longnum(8.5));
+        CHECK((a * b).approx(20) == Longnum(-10.5));
+        CHECK((-a).approx(20) == Longnum(-1.5));
+
+        Real third{Real(1) / Real(3)};
+        for (Longnum::Precision p : {0, 1, 10, 100, 1000}) {
+            CHECK(close(third.approx(p), one_third, p));
+            CHECK(close((third * 3).approx(p), Longnum(1), p));
+            CHECK(close((third - Real(1) / 3).approx(p), Longnum(0), p));
+        }
+    }
+
+    SUBCASE("Approximated values") {
+        Real s{sqrt2};
+        CHECK(close(s.approx(64), sqrt2(200), 64));
+
+        // sqrt(2)^2 / 2 = 1
+        Real expr{s * s / 2};
+        for (Longnum::Precision p : {0, 5, 50, 500}) {
+            CHECK(close(expr.approx(p), Longnum(1), p));
+        }
+
+        // Division by a tiny number
+        Real tiny{Real(1) / Real(Longnum(1, 300) >> 300)};
+        Real big{s / (s * tiny)};
+        CHECK(close(big.approx(10), Longnum(1) >> 300, 10));
+    }
+
+    SUBCASE("Caching") {
+        int calls{0};
+        Longnum::Precision max_prec{0};
+        Real s{[&calls, &max_prec](Longnum::Precision p) {
+            calls++;
+            max_prec = max(max_prec, p);
+            return sqrt2(p);
+        }};
+
+        Real expr{s * s + s};
+        expr.approx(100);
+        auto after_first{calls};
+        expr.approx(50);
+        expr.approx(100);
+        CHECK(calls == after_first);
+        CHECK(max_prec >= 100);
+
+        expr.approx(200);
+        CHECK(calls > after_first);
+        CHECK(max_prec >= 200);
+    }
+
+    SUBCASE("Division by zero") {
+        CHECK_THROWS((Real(1) / Real(0)).approx(10));
+        CHECK_THROWS((Real(1) / (Real(1) / 3 - Real(1) / 3)).approx(10));
+    }
+}